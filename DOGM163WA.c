@@ -18,6 +18,7 @@
 // /SS1 -> PB1
 // RS0 -> PC0
 // RS1 -> PC1
+// The /SS and RS pins of the other DOG LCDs are listed in lcd_panels below.
 //
 // Warnings :
 // Restrictions : none
@@ -29,109 +30,1064 @@
 //
 //**************************************************************************
 
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
 #include "DOGM163WA.h"
 
+#define LCD_TXQ_SIZE 128						// Entries in the transmit queue, must be a power of 2
+#define LCD_NONE 0xFF							// No DOG LCD selected
+
+// States of the transmit queue
+#define LCD_TXQ_IDLE 0							// Nothing in flight, every /SS line is high
+#define LCD_TXQ_SHIFT 1							// A byte is being shifted out by SPI0, or one or two by USART0
+#define LCD_TXQ_GAP 2							// TCB0 is timing the wait for a DOG LCD to finish executing
+
+#if LCD_PANELS < 1 || LCD_PANELS > 8
+#error "LCD_PANELS must be between 1 and 8"
+#endif
+
+typedef struct {
+	VPORT_t* ss_port;							// Port of the /SS line
+	uint8_t ss_bm;
+	VPORT_t* rs_port;							// Port of the RS line
+	uint8_t rs_bm;
+} lcd_panel_t;
+
+// Wiring of each DOG LCD, in order from left to right
+static const lcd_panel_t lcd_panels[LCD_PANELS] = {
+	{ &VPORTB, PIN0_bm, &VPORTC, PIN0_bm },		// LCD0: /SS0 -> PB0, RS0 -> PC0
+#if LCD_PANELS > 1
+	{ &VPORTB, PIN1_bm, &VPORTC, PIN1_bm },		// LCD1: /SS1 -> PB1, RS1 -> PC1
+#endif
+#if LCD_PANELS > 2
+	{ &VPORTB, PIN3_bm, &VPORTC, PIN2_bm },		// LCD2: /SS2 -> PB3, RS2 -> PC2 (PB2 is the pushbutton)
+#endif
+#if LCD_PANELS > 3
+	{ &VPORTB, PIN4_bm, &VPORTC, PIN3_bm },		// LCD3: /SS3 -> PB4, RS3 -> PC3
+#endif
+#if LCD_PANELS > 4
+	{ &VPORTB, PIN5_bm, &VPORTC, PIN4_bm },		// LCD4: /SS4 -> PB5, RS4 -> PC4
+#endif
+#if LCD_PANELS > 5
+	{ &VPORTD, PIN0_bm, &VPORTC, PIN5_bm },		// LCD5: /SS5 -> PD0, RS5 -> PC5
+#endif
+#if LCD_PANELS > 6
+	{ &VPORTD, PIN1_bm, &VPORTC, PIN6_bm },		// LCD6: /SS6 -> PD1, RS6 -> PC6
+#endif
+#if LCD_PANELS > 7
+	{ &VPORTD, PIN2_bm, &VPORTC, PIN7_bm },		// LCD7: /SS7 -> PD2, RS7 -> PC7
+#endif
+};
+
+typedef struct {
+	uint8_t LCD;								// DOG LCD the byte is sent to
+	uint8_t rs;									// RS level, 0 for command and 1 for data
+	unsigned char byte;							// Serial byte
+	uint8_t gap;								// Gap class to leave after the byte, one of LCD_GAP_*
+} lcd_tx_t;
+
+// Waits after each initialization command
+#define LCD_WAIT_EXEC 0							// Execution time of the command, from the timing profile
+#define LCD_WAIT_FOLLOWER 1						// 200ms for the follower circuit to settle
+
+typedef struct {
+	unsigned char cmd;							// Command sent to every DOG LCD
+	uint8_t wait;								// LCD_WAIT_EXEC or LCD_WAIT_FOLLOWER
+} lcd_init_t;
+
+static const lcd_init_t lcd_init_3line[] PROGMEM = {
+	{ 0x39, LCD_WAIT_EXEC },					// func_set1: 8 bit, 3 lines, instruction table 1
+	{ 0x39, LCD_WAIT_EXEC },					// func_set2
+	{ 0x1E, LCD_WAIT_EXEC },					// bias_set: set bias value
+	{ 0x55, LCD_WAIT_EXEC },					// power_ctrl: ~ 0x50 nominal for 5V, ~ 0x55 for 3.3V (delicate adjustment)
+	{ 0x6C, LCD_WAIT_FOLLOWER },				// follower_ctrl: follower mode on
+	{ 0x7F, LCD_WAIT_EXEC },					// contrast_set: ~ 77 for 5V, ~ 7F for 3.3V
+	{ 0x0C, LCD_WAIT_EXEC },					// display_on: display on, cursor off, blink off
+	{ 0x01, LCD_WAIT_EXEC },					// clr_display: clear display, cursor home
+	{ 0x06, LCD_WAIT_EXEC }						// entry_mode: cursor auto-increment
+};
+
+static const lcd_init_t lcd_init_big[] PROGMEM = {
+	{ 0x35, LCD_WAIT_EXEC },					// func_set1: 8 bit, 1 line, double height, instruction table 1
+	{ 0x35, LCD_WAIT_EXEC },					// func_set2
+	{ 0x1E, LCD_WAIT_EXEC },					// bias_set: set bias value
+	{ 0x55, LCD_WAIT_EXEC },					// power_ctrl: ~ 0x50 nominal for 5V, ~ 0x55 for 3.3V (delicate adjustment)
+	{ 0x6C, LCD_WAIT_FOLLOWER },				// follower_ctrl: follower mode on
+	{ 0x7F, LCD_WAIT_EXEC },					// contrast_set: ~ 77 for 5V, ~ 7F for 3.3V
+	{ 0x0C, LCD_WAIT_EXEC },					// display_on: display on, cursor off, blink off
+	{ 0x01, LCD_WAIT_EXEC },					// clr_display: clear display, cursor home
+	{ 0x06, LCD_WAIT_EXEC }						// entry_mode: cursor auto-increment
+};
+
+#define LCD_INIT_STEPS(seq) (sizeof(seq) / sizeof((seq)[0]))
+
+// TCB0 counts at the current CPU clock and SCK rate, set by lcd_spi_clock
+static uint16_t lcd_exec_ticks[3];				// Execution time of each gap class, LCD_GAP_NONE stays 0
+static uint16_t lcd_byte_ticks;					// Time one byte spends on the wire
+
+_Static_assert(LCD_EXEC_TICKS(LCD_EXEC_CLEAR_NS, SYSCLK_FAST_MHZ) <= 0xFFFF, "the clear execution time must fit in TCB0");
+
+static uint16_t lcd_busy[LCD_PANELS];			// TCB0 counts each DOG LCD is still executing for, from the end of the last byte shifted out
+
+static lcd_tx_t lcd_txq[LCD_TXQ_SIZE];
+static volatile uint8_t lcd_txq_head;			// Next free entry, only written by producers
+static volatile uint8_t lcd_txq_tail;			// Next entry to send, only written by the drain
+static volatile uint8_t lcd_txq_state = LCD_TXQ_IDLE;
+static uint8_t lcd_txq_gap;						// Gap class of the byte in flight, the last one written with LCD_USART
+static uint8_t lcd_txq_lcd = LCD_NONE;			// DOG LCD currently selected by the drain
+static void (*lcd_txq_notify)(void);			// Called once the entry at lcd_txq_mark has been sent
+static uint8_t lcd_txq_mark;
+static uint16_t lcd_txq_wait;					// TCB0 counts of the wait in progress
+#if LCD_USART
+static uint8_t lcd_txq_rs;						// RS level of the byte in flight
+static uint8_t lcd_txq_bytes;					// Bytes written since lcd_txq_next, counting the ones lcd_txq_chain added
+#endif
+
+static char lcd_shadow[LCD_PANELS][LCD_DDRAM_SIZE];	// Copy of the characters held in each DOG LCD's DDRAM
+static unsigned char lcd_func = LCD_FUNC_3LINE;	// Last function set sent to every DOG LCD
+
+//***************************************************************************
+//
+// Function Name : static void lcd_ss (uint8_t LCD, uint8_t level) & static void lcd_rs (uint8_t LCD, uint8_t level)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// These functions drive the /SS line or the RS line of the specified DOG LCD to level,
+// using the pins from lcd_panels. LCD_ALL drives the line of every DOG LCD, and LCD_NONE
+// does nothing. A single DOG LCD costs the same however many are in the chain.
+//
+//**************************************************************************
+
+static void lcd_ss (uint8_t LCD, uint8_t level) {
+	if (LCD == LCD_NONE) return;
+	for (uint8_t i = (LCD == LCD_ALL) ? 0 : LCD; i < LCD_PANELS; i++) {
+		if (level)
+			lcd_panels[i].ss_port->OUT |= lcd_panels[i].ss_bm;		// /SS = 1 to de-select
+		else
+			lcd_panels[i].ss_port->OUT &= ~lcd_panels[i].ss_bm;		// /SS = 0 to select
+		if (LCD != LCD_ALL) break;
+	}
+}
+
+static void lcd_rs (uint8_t LCD, uint8_t level) {
+	for (uint8_t i = (LCD == LCD_ALL) ? 0 : LCD; i < LCD_PANELS; i++) {
+		if (level)
+			lcd_panels[i].rs_port->OUT |= lcd_panels[i].rs_bm;		// RS = 1 for data
+		else
+			lcd_panels[i].rs_port->OUT &= ~lcd_panels[i].rs_bm;		// RS = 0 for command
+		if (LCD != LCD_ALL) break;
+	}
+}
+
+//***************************************************************************
+//
+// Function Name : static uint16_t lcd_busy_left (uint8_t LCD) & static void lcd_busy_set (uint8_t LCD, uint16_t ticks) &
+//				   static void lcd_busy_pass (uint16_t ticks)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// These functions keep track of how long each DOG LCD is still executing, in TCB0 counts.
+// lcd_busy_left returns the time left on the specified DOG LCD, the longest of them for
+// LCD_ALL and none for LCD_NONE. lcd_busy_set starts the execution time of a byte that has
+// just been shifted out, and lcd_busy_pass takes the time that has gone by off every DOG
+// LCD. Only the time the drain knows of is taken off, the bytes on the wire and the waits
+// timed by TCB0, so the time left never comes out shorter than it really is.
+//
+//**************************************************************************
+
+static uint16_t lcd_busy_left (uint8_t LCD) {
+	uint16_t left = 0;
+	for (uint8_t i = (LCD == LCD_ALL) ? 0 : LCD; i < LCD_PANELS; i++) {
+		if (lcd_busy[i] > left)
+			left = lcd_busy[i];
+		if (LCD != LCD_ALL) break;
+	}
+	return left;
+}
+
+static void lcd_busy_set (uint8_t LCD, uint16_t ticks) {
+	for (uint8_t i = (LCD == LCD_ALL) ? 0 : LCD; i < LCD_PANELS; i++) {
+		lcd_busy[i] = ticks;
+		if (LCD != LCD_ALL) break;
+	}
+}
+
+static void lcd_busy_pass (uint16_t ticks) {
+	for (uint8_t i = 0; i < LCD_PANELS; i++)
+		lcd_busy[i] = lcd_busy[i] > ticks ? lcd_busy[i] - ticks : 0;
+}
+
+//***************************************************************************
+//
+// Function Name : static void lcd_txq_wait_for (uint16_t ticks)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function starts TCB0 as a one-shot for ticks counts, after which lcd_txq_gap_done
+// runs.
+//
+// Warnings : Must be called with interrupts disabled
+//
+//**************************************************************************
+
+static void lcd_txq_wait_for (uint16_t ticks) {
+	lcd_txq_wait = ticks;
+	lcd_txq_state = LCD_TXQ_GAP;
+	TCB0.CNT = 0;
+	TCB0.CCMP = ticks - 1;					// TCB0 interrupts after CCMP + 1 counts
+	TCB0.CTRLA = TCB_CLKSEL_DIV1_gc | TCB_ENABLE_bm;
+}
+
+//***************************************************************************
+//
+// Function Name : static void lcd_txq_next (void)
+// Date : 10/16/2026
+// Version : 1.3
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function starts the next queued byte. /SS is only switched when the byte is for a
+// different DOG LCD than the last one, so a burst keeps its device selected throughout.
+// If the DOG LCD the byte is for is still executing, TCB0 first waits out the rest of its
+// execution time, less the time the byte spends on the wire, so the ST7036 finishes just
+// as the byte arrives. A byte for another DOG LCD doesn't wait for that one at all. When
+// the queue is empty, TCB0 waits until every DOG LCD is done, since the CPU clock, and
+// with it SCK, may go up before the next byte. Then the DOG LCD is de-selected and the
+// SPI interrupt is turned off so the polled transmit functions can use SPI0 again. With LCD_USART the byte goes
+// straight on to the USART0 shift register, and the data register empty interrupt is
+// turned on if the byte leaves no gap, so lcd_txq_chain can put the next one behind it.
+//
+// Warnings : Must be called with interrupts disabled
+//
+// Revision History : Initial version
+//					  1.1 - Pins taken from lcd_panels
+//					  1.2 - USART0 backend
+//					  1.3 - Waits for the byte's own DOG LCD only
+//
+//**************************************************************************
+
+static void lcd_txq_next (void) {
+	if (lcd_txq_head == lcd_txq_tail) {
+		uint16_t left = lcd_busy_left(LCD_ALL);
+		if (left) {
+			lcd_txq_wait_for(left);
+			return;
+		}
+#if LCD_USART
+		USART0.CTRLA &= ~(USART_TXCIE_bm | USART_DREIE_bm);
+#else
+		SPI0.INTCTRL &= ~SPI_IE_bm;
+#endif
+		lcd_ss(lcd_txq_lcd, 1);				// De-selects the last DOG LCD
+		lcd_txq_lcd = LCD_NONE;
+		lcd_txq_state = LCD_TXQ_IDLE;
+		return;
+	}
+
+	lcd_tx_t* tx = &lcd_txq[lcd_txq_tail];
+	uint16_t left = lcd_busy_left(tx->LCD);
+	
+	if (left > lcd_byte_ticks) {			// The byte's time on the wire covers the rest
+		lcd_txq_wait_for(left - lcd_byte_ticks);
+		return;
+	}
+
+	if (tx->LCD != lcd_txq_lcd) {
+		lcd_ss(lcd_txq_lcd, 1);				// De-selects the last DOG LCD
+		lcd_ss(tx->LCD, 0);					// Selects the DOG LCD, or all of them for LCD_ALL
+		lcd_txq_lcd = tx->LCD;
+	}
+	lcd_rs(tx->LCD, tx->rs);
+
+	lcd_txq_gap = tx->gap;
+	lcd_txq_state = LCD_TXQ_SHIFT;
+	lcd_txq_tail = (lcd_txq_tail + 1) & (LCD_TXQ_SIZE - 1);
+
+#if LCD_USART
+	lcd_txq_rs = tx->rs;
+	lcd_txq_bytes = 1;
+	USART0.STATUS = USART_TXCIF_bm;			// Clears the TXC flag of the last byte
+	USART0.CTRLA = (USART0.CTRLA & ~USART_DREIE_bm) | USART_TXCIE_bm | (tx->gap == LCD_GAP_NONE ? USART_DREIE_bm : 0);
+	USART0.TXDATAL = tx->byte;
+#else
+	(void)SPI0.INTFLAGS;					// Reading INTFLAGS then writing DATA clears a stale IF flag
+	SPI0.INTCTRL |= SPI_IE_bm;
+	SPI0.DATA = tx->byte;
+#endif
+}
+
+#if LCD_USART
+//***************************************************************************
+//
+// Function Name : static void lcd_txq_chain (void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function is run when the USART0 transmit buffer is empty while a byte is shifted
+// out. It writes the next queued byte into the buffer, so it follows on the wire with no
+// break, as long as it can go out without anything being done in between:
+// 1) The byte ahead of it leaves no gap
+// 2) It is for the same DOG LCD, with the same RS level, so /SS and RS don't change
+// 3) The byte ahead of it isn't the one lcd_spi_notify is waiting for
+// Otherwise the data register empty interrupt is turned off, and the byte is started by
+// lcd_txq_next once the transmit complete interrupt has come in.
+//
+// Warnings : Must be called with interrupts disabled
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+static void lcd_txq_chain (void) {
+	lcd_tx_t* tx = &lcd_txq[lcd_txq_tail];
+	
+	if (lcd_txq_gap != LCD_GAP_NONE || lcd_txq_head == lcd_txq_tail || tx->LCD != lcd_txq_lcd || tx->rs != lcd_txq_rs
+		|| (lcd_txq_notify && lcd_txq_mark == ((lcd_txq_tail - 1) & (LCD_TXQ_SIZE - 1)))) {
+		USART0.CTRLA &= ~USART_DREIE_bm;
+		return;
+	}
+	lcd_txq_gap = tx->gap;
+	lcd_txq_bytes++;
+	lcd_txq_tail = (lcd_txq_tail + 1) & (LCD_TXQ_SIZE - 1);
+	USART0.TXDATAL = tx->byte;
+	USART0.STATUS = USART_TXCIF_bm;			// The byte ahead may have just finished, the byte written now will set TXC again
+}
+#endif
+
+//***************************************************************************
+//
+// Function Name : static void lcd_txq_sent (void) & static void lcd_txq_gap_done (void)
+// Date : 10/16/2026
+// Version : 1.3
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// These functions advance the transmit queue. Once a byte is shifted out, its time on the
+// wire is taken off every DOG LCD's execution time, the DOG LCD it went to starts the
+// execution time of its gap class, and the next byte is started. When a wait timed by
+// TCB0 is over, it is taken off as well and the next byte is started. The lcd_spi_notify
+// callback is run as soon as its byte has been shifted out. With LCD_USART, lcd_txq_sent
+// is run once the last byte lcd_txq_chain wrote has gone out.
+//
+// Warnings : Must be called with interrupts disabled
+//
+// Revision History : Initial version
+//					  1.1 - Gap taken from the timing profile in TCB0 counts
+//					  1.2 - Whole execution time after the last byte in the queue
+//					  1.3 - Execution time kept for each DOG LCD
+//
+//**************************************************************************
+
+static void lcd_txq_sent (void) {
+	if (lcd_txq_notify && lcd_txq_mark == ((lcd_txq_tail - 1) & (LCD_TXQ_SIZE - 1))) {
+		void (*notify)(void) = lcd_txq_notify;
+		lcd_txq_notify = 0;
+		notify();
+	}
+#if LCD_USART
+	lcd_busy_pass(lcd_byte_ticks * lcd_txq_bytes);
+#else
+	lcd_busy_pass(lcd_byte_ticks);
+#endif
+	lcd_busy_set(lcd_txq_lcd, lcd_exec_ticks[lcd_txq_gap]);
+	lcd_txq_next();
+}
+
+static void lcd_txq_gap_done (void) {
+	TCB0.CTRLA = 0;							// Stops TCB0 until the next wait
+	TCB0.INTFLAGS = TCB_CAPT_bm;			// Clears the Interrupt flag
+	lcd_busy_pass(lcd_txq_wait);
+	lcd_txq_next();
+}
+
+//***************************************************************************
+//
+// Function Name : static void lcd_txq_poll (void)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function drains the transmit queue by polling the SPI0 (or USART0) and TCB0 flags.
+// It is only used while global interrupts are disabled (for example when called from
+// inside another ISR), where their interrupts can't run. Otherwise it does nothing.
+//
+// Revision History : Initial version
+//					  1.1 - USART0 flags
+//
+//**************************************************************************
+
+static void lcd_txq_poll (void) {
+	if (SREG & CPU_I_bm) return;			// The ISRs drain the queue
+
+#if LCD_USART
+	if (lcd_txq_state == LCD_TXQ_SHIFT && (USART0.CTRLA & USART_DREIE_bm) && (USART0.STATUS & USART_DREIF_bm))
+		lcd_txq_chain();
+	else if (lcd_txq_state == LCD_TXQ_SHIFT && (USART0.STATUS & USART_TXCIF_bm)) {
+		USART0.STATUS = USART_TXCIF_bm;		// Clears the TXC flag
+		lcd_txq_sent();
+	}
+#else
+	if (lcd_txq_state == LCD_TXQ_SHIFT && (SPI0.INTFLAGS & SPI_IF_bm)) {
+		(void)SPI0.DATA;					// Reading INTFLAGS then DATA clears the IF flag
+		lcd_txq_sent();
+	}
+#endif
+	else if (lcd_txq_state == LCD_TXQ_GAP && (TCB0.INTFLAGS & TCB_CAPT_bm))
+		lcd_txq_gap_done();
+}
+
+//***************************************************************************
+//
+// Function Name : ISR (SPI0_INT_vect) & ISR (TCB0_INT_vect)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// These interrupts drain the transmit queue in the background. SPI0 interrupts when a byte
+// has been shifted out, and TCB0 interrupts when the execution gap after it has passed.
+// With LCD_USART, USART0 takes the place of SPI0 with two interrupts: data register empty
+// when the transmit buffer can take the next byte, and transmit complete when the last
+// byte has been shifted out.
+//
+// Revision History : Initial version
+//					  1.1 - USART0 interrupts
+//
+//**************************************************************************
+
+#if LCD_USART
+ISR (USART0_DRE_vect) {
+	if (lcd_txq_state == LCD_TXQ_SHIFT)
+		lcd_txq_chain();
+	else
+		USART0.CTRLA &= ~USART_DREIE_bm;
+}
+
+ISR (USART0_TXC_vect) {
+	USART0.STATUS = USART_TXCIF_bm;			// Clears the Interrupt flag
+	if (lcd_txq_state == LCD_TXQ_SHIFT)
+		lcd_txq_sent();
+}
+#else
+ISR (SPI0_INT_vect) {
+	if (lcd_txq_state == LCD_TXQ_SHIFT)
+		lcd_txq_sent();
+}
+#endif
+
+ISR (TCB0_INT_vect) {
+	if (lcd_txq_state == LCD_TXQ_GAP)
+		lcd_txq_gap_done();
+	else
+		TCB0.INTFLAGS = TCB_CAPT_bm;		// Clears the Interrupt flag
+}
+
 //***************************************************************************
 //
 // Function Name : void lcd_spi_transmit_CMD (uint8_t LCD, unsigned char cmd)
 // Date : 3/29/2024
-// Version : 1.0
+// Version : 1.1
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong & Kenneth Short
 // 
 // This function transmits a command character to the specified DOG LCD. The steps are shown below:
-// 1) Select the device by pulling the /SS0 or /SS1 line low
-// 2) Pull the RS0 or RS1 line to a 0 for the DOG LCD to interpret the serial byte packet as a command
+// 1) Select the device by pulling its /SS line low, or every /SS line for LCD_ALL
+// 2) Pull its RS line to a 0 for the DOG LCD to interpret the serial byte packet as a command
 // 3) Transmit the serial byte by placing cmd into the SPI data register
-// 4) Wait until the data transmission is complete by polling for the IF flag
-// 5) De-select the device by pulling the /SS0 or /SS1 line high
+// 4) Wait until the data transmission is complete and the command has been executed
+// 5) De-select the device by pulling its /SS line high
+// The steps are carried out by the transmit queue, with the gap for the command's type
+// (1.08ms for clear display and return home, 26.3us for the rest), so the caller doesn't
+// need to add a delay of its own.
 //
 // Warnings : none
-// Restrictions : none
-// Algorithms : none
+// Restrictions : The 200ms follower wait is still left to the caller
+// Algorithms : lcd_spi_enqueue, lcd_spi_flush
 // References : none
 //
 // Revision History : Initial version
+//					  1.1 - Pins taken from lcd_panels
+//					  1.2 - Waits out the execution time from the timing profile
 //
 //**************************************************************************
  
 void lcd_spi_transmit_CMD (uint8_t LCD, unsigned char cmd) {
-	if (!LCD) {
-		VPORTB.OUT |= PIN1_bm; // /SS1 = 1 to de-select LCD1
-		VPORTB.OUT &= ~PIN0_bm; // /SS0 = 0 to select LCD0
-		VPORTC.OUT &= ~PIN0_bm; // RS0 = 0 for command
-	}
-	else {
-		VPORTB.OUT |= PIN0_bm;  // /SS0 = 1 to de-select LCD0
-		VPORTB.OUT &= ~PIN1_bm; // /SS1 = 0 to select LCD1
-		VPORTC.OUT &= ~PIN1_bm; // RS1 = 0 for command
-	}
-	
-	SPI0.DATA = cmd;		//send command
-	while(!(SPI0.INTFLAGS & SPI_IF_bm)) {}    // Wait until IF flag is set
-		
-	VPORTB.OUT |= PIN0_bm | PIN1_bm; // /SS0 = 1 and /SS1 = 1 to de-select LCD0 and LCD1
+	lcd_spi_enqueue(LCD, 0, cmd, LCD_CMD_GAP(cmd));	// RS = 0 for command
+	lcd_spi_flush();		// Wait until it is sent and executed
 }
 
 //***************************************************************************
 //
 // Function Name : void lcd_spi_transmit_CMD (uint8_t LCD, unsigned char cmd)
 // Date : 3/29/2024
-// Version : 1.0
+// Version : 1.1
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong & Kenneth Short
 //
 // This function transmits a data byte to the specified DOG LCD. The steps are shown below:
-// 1) Select the device by pulling the /SS0 or /SS1 line low
-// 2) Pull the RS0 or RS1 line to a 0 for the DOG LCD to interpret the serial byte packet as a data
+// 1) Select the device by pulling its /SS line low, or every /SS line for LCD_ALL
+// 2) Pull its RS line to a 1 for the DOG LCD to interpret the serial byte packet as a data
 // 3) Transmit the serial byte by placing cmd into the SPI data register
-// 4) Wait until the data transmission is complete by polling for the IF flag
-// 5) De-select the device by pulling the /SS0 or /SS1 line high
+// 4) Wait until the data transmission is complete and the 26.3us write has finished
+// 5) De-select the device by pulling its /SS line high
+// The steps are carried out by the transmit queue, so the caller doesn't need to add a
+// delay of its own.
 //
 // Warnings : none
 // Restrictions : none
-// Algorithms : none
+// Algorithms : lcd_spi_enqueue, lcd_spi_flush
 // References : none
 //
 // Revision History : Initial version
+//					  1.1 - Pins taken from lcd_panels
+//					  1.2 - Waits out the execution time from the timing profile
 //
 //**************************************************************************
 
 void lcd_spi_transmit_DATA (uint8_t LCD, unsigned char cmd) {
-	if (!LCD) {
-		VPORTB.OUT |= PIN1_bm; // /SS1 = 1 to de-select LCD1
-		VPORTB.OUT &= ~PIN0_bm;	// /SS0 = 0 to select LCD0
-		VPORTC.OUT |= PIN0_bm; // RS0 = 1 for data
+	lcd_spi_enqueue(LCD, 1, cmd, LCD_GAP_EXEC);		// RS = 1 for data
+	lcd_spi_flush();		// Wait until it is sent and written
+}
+
+//***************************************************************************
+//
+// Function Name : void lcd_spi_enqueue (uint8_t LCD, uint8_t rs, unsigned char byte, uint8_t gap)
+// Date : 10/16/2026
+// Version : 1.2
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function places a byte on the interrupt driven transmit queue and returns
+// without waiting for it to be sent. Each entry holds the DOG LCD to select, the RS level,
+// the serial byte and the gap class to leave after it. LCD_ALL broadcasts the byte. The SPI0 and TCB0
+// interrupts switch /SS and RS, send the byte and time the gap in the background.
+// If the queue is full, this function waits until there is room. With LCD_USART, a byte
+// that can follow the one in flight with no gap is put into the USART0 transmit buffer
+// while that one is still shifted out.
+//
+// Warnings : Called with interrupts disabled, the queue is drained by polling instead
+// Restrictions : gap must be LCD_GAP_NONE, LCD_GAP_EXEC or LCD_GAP_CLEAR. LCD_CMD_GAP gives
+//				  the class for a command. The 200ms follower wait goes through sysclk_delay_ms,
+//				  which follows the clock in use, not through the queue.
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - gap is a class from the timing profile instead of a time in us
+//					  1.2 - Fills the USART0 transmit buffer
+//
+//**************************************************************************
+
+void lcd_spi_enqueue (uint8_t LCD, uint8_t rs, unsigned char byte, uint8_t gap) {
+	uint8_t next = (lcd_txq_head + 1) & (LCD_TXQ_SIZE - 1);
+	while (next == lcd_txq_tail) lcd_txq_poll();	// Waits for room in the queue
+
+	lcd_tx_t* tx = &lcd_txq[lcd_txq_head];
+	tx->LCD = LCD;
+	tx->rs = rs;
+	tx->byte = byte;
+	tx->gap = gap;
+
+	uint8_t sreg = SREG;
+	cli();
+#if LCD_USART
+	uint8_t first = lcd_txq_head == lcd_txq_tail;
+#endif
+	lcd_txq_head = next;
+	if (lcd_txq_state == LCD_TXQ_IDLE)		// Starts the drain if it had run dry
+		lcd_txq_next();
+#if LCD_USART
+	else if (first && lcd_txq_state == LCD_TXQ_SHIFT && lcd_txq_gap == LCD_GAP_NONE)
+		USART0.CTRLA |= USART_DREIE_bm;		// The byte may fit in the transmit buffer behind the one in flight
+#endif
+	SREG = sreg;
+}
+
+//***************************************************************************
+//
+// Function Name : void lcd_spi_flush (void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function waits until every queued byte has been sent and its execution gap
+// has passed, and every DOG LCD is de-selected.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void lcd_spi_flush (void) {
+	while (lcd_txq_state != LCD_TXQ_IDLE) lcd_txq_poll();
+}
+
+//***************************************************************************
+//
+// Function Name : void lcd_spi_clock (void) & uint8_t lcd_spi_idle (void)
+// Date : 10/16/2026
+// Version : 1.3
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// lcd_spi_clock works out the SPI timing profile for the CPU clock set in sysclk. The
+// steps are shown below:
+// 1) Picks the smallest SPI0 divider that keeps SCK at or under LCD_SCK_MAX_HZ, or with
+//	  LCD_USART the smallest even USART0 divider, which can get much closer to it
+// 2) Sets the SPI0 prescaler and CLK2X bits, or the USART0 BAUD register, for that divider
+// 3) Works out the TCB0 counts of the ST7036 execution time of each gap class, and of
+//	  the time a byte spends on the wire at the new SCK rate
+// lcd_spi_idle returns 1 once every queued byte has been sent and its gap has passed,
+// which is when the CPU clock can be changed.
+//
+// Warnings : Call lcd_spi_clock only while lcd_spi_idle, right after every change of the CPU clock
+// Restrictions : none
+// Algorithms : LCD_BYTE_TICKS, LCD_EXEC_TICKS
+// References : ST7036 datasheet, execution times
+//
+// Revision History : Initial version
+//					  1.1 - Counts of the whole execution times
+//					  1.2 - USART0 divider
+//					  1.3 - Execution times and byte time kept apart, for the time left on each DOG LCD
+//
+//**************************************************************************
+
+void lcd_spi_clock (void) {
+	uint8_t mhz = sysclk_mhz();
+#if LCD_USART
+	uint8_t div = 2 * ((mhz * 1000000UL + 2 * LCD_SCK_MAX_HZ - 1) / (2 * LCD_SCK_MAX_HZ));
+	
+	USART0.BAUD = (uint16_t)(div / 2) << 6;		// SCK = CPU clock / (2 * BAUD[15:6]) in master SPI mode
+#else
+	static const uint8_t presc[] = {			// SPI0 prescaler and CLK2X bits for dividers 2, 4, 8 ... 128
+		SPI_PRESC_DIV4_gc | SPI_CLK2X_bm, SPI_PRESC_DIV4_gc,
+		SPI_PRESC_DIV16_gc | SPI_CLK2X_bm, SPI_PRESC_DIV16_gc,
+		SPI_PRESC_DIV64_gc | SPI_CLK2X_bm, SPI_PRESC_DIV64_gc,
+		SPI_PRESC_DIV128_gc
+	};
+	uint8_t i = 0;
+	uint8_t div = 2;
+	
+	while (i < sizeof(presc) - 1 && mhz * 1000000UL / div > LCD_SCK_MAX_HZ) {
+		i++;
+		div <<= 1;
 	}
-	else {
-		VPORTB.OUT |= PIN0_bm; // /SS0 = 1 to de-select LCD0
-		VPORTB.OUT &= ~PIN1_bm; // /SS1 = 0 to select LCD1
-		VPORTC.OUT |= PIN1_bm; // RS1 = 1 for data
+	SPI0.CTRLA = (SPI0.CTRLA & ~(SPI_PRESC_gm | SPI_CLK2X_bm)) | presc[i];
+#endif
+	
+	lcd_byte_ticks = LCD_BYTE_TICKS(div);
+	lcd_exec_ticks[LCD_GAP_EXEC] = LCD_EXEC_TICKS(LCD_EXEC_NS, mhz);
+	lcd_exec_ticks[LCD_GAP_CLEAR] = LCD_EXEC_TICKS(LCD_EXEC_CLEAR_NS, mhz);
+}
+
+uint8_t lcd_spi_idle (void) {
+	return lcd_txq_state == LCD_TXQ_IDLE;
+}
+
+//***************************************************************************
+//
+// Function Name : void lcd_spi_notify (void (*fn)(void))
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function arranges for fn to be called once the last byte queued so far has
+// been shifted out to its DOG LCD, which is when a frame queued just before becomes
+// visible. If the queue is already empty, fn is called right away. Only one callback
+// can be pending, a new one replaces the old one.
+//
+// Warnings : fn usually runs inside the SPI0 interrupt and must be short
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void lcd_spi_notify (void (*fn)(void)) {
+	uint8_t sreg = SREG;
+	cli();
+	if (lcd_txq_head == lcd_txq_tail && lcd_txq_state != LCD_TXQ_SHIFT) {
+		lcd_txq_notify = 0;					// The last byte is already out
+		SREG = sreg;
+		fn();
+		return;
 	}
+	lcd_txq_notify = fn;
+	lcd_txq_mark = (lcd_txq_head - 1) & (LCD_TXQ_SIZE - 1);
+	SREG = sreg;
+}
+
+//***************************************************************************
+//
+// Function Name : void lcd_spi_write_block (uint8_t LCD, uint8_t addr, const char* buf, uint8_t len)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function places a block of characters for the DDRAM of the specified DOG LCD on
+// the transmit queue, to be sent as a single burst. The steps are shown below:
+// 1) Queue the set DDRAM address command (0x80 | addr) with RS low and LCD_GAP_EXEC
+// 2) Queue all len characters with RS high and LCD_GAP_EXEC, letting the DOG LCD
+//	  auto-increment the address counter after every character
+// The queue's interrupts pull the /SS line of the DOG LCD low, or every /SS line for
+// LCD_ALL, switch RS and send the bytes in the background. Each byte is only padded by the
+// part of the execution time that the transfer itself did not already cover.
+//
+// Warnings : buf is copied into the queue at once but sent later, so the DOG LCD doesn't
+//			  show it yet when this function returns. The entry mode must be set to
+//			  auto-increment (0x06), which init_lcd_dog does
+// Restrictions : addr + len must stay inside the 48 character DDRAM used in 3 line mode
+// Algorithms : lcd_spi_enqueue
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Header describes the queued transfer
+//
+//**************************************************************************
+
+void lcd_spi_write_block (uint8_t LCD, uint8_t addr, const char* buf, uint8_t len) {
+	lcd_spi_enqueue(LCD, 0, 0x80 | addr, LCD_GAP_EXEC);		// set DDRAM address
+
+	for (uint8_t i = 0; i < len; i++)
+		lcd_spi_enqueue(LCD, 1, buf[i], LCD_GAP_EXEC);		// send character, address counter auto-increments
+}
+
+//***************************************************************************
+//
+// Function Name : static uint8_t lcd_shadow_differs (uint8_t LCD, uint8_t pos, char c)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns 1 if DDRAM address pos of the specified DOG LCD doesn't hold c.
+// With LCD_ALL it returns 1 if any DOG LCD doesn't hold c.
+//
+//**************************************************************************
+
+static uint8_t lcd_shadow_differs (uint8_t LCD, uint8_t pos, char c) {
+	if (LCD != LCD_ALL)
+		return lcd_shadow[LCD][pos] != c;
+	for (uint8_t i = 0; i < LCD_PANELS; i++)		// Changed if any DOG LCD needs it
+		if (lcd_shadow[i][pos] != c)
+			return 1;
+	return 0;
+}
+
+//***************************************************************************
+//
+// Function Name : static uint8_t lcd_shadow_run (uint8_t LCD, uint8_t addr, const char* buf, uint8_t len, uint8_t* i)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function finds the next run of characters of buf that the specified DOG LCD
+// doesn't show yet, from *i on, and returns where it starts, leaving *i at its end. It
+// returns len if there is none. Two runs separated by a single unchanged character are
+// one run, since re-sending that character costs the same as a new address command.
+//
+//**************************************************************************
+
+static uint8_t lcd_shadow_run (uint8_t LCD, uint8_t addr, const char* buf, uint8_t len, uint8_t* i) {
+	uint8_t j = *i;
 	
-	SPI0.DATA = cmd;		//send command
-	while(!(SPI0.INTFLAGS & SPI_IF_bm)) {}    // Wait until IF flag is set
+	while (j < len && !lcd_shadow_differs(LCD, addr + j, buf[j]))	// Skips characters the DOG LCD already shows
+		j++;
+	uint8_t start = j;
 	
-	VPORTB.OUT |= PIN0_bm | PIN1_bm; // /SS0 = 1 and /SS1 = 1 to de-select LCD0 and LCD1
-}
-
+	if (j < len) {
+		uint8_t end = ++j;								// Grows the run until two unchanged characters in a row
+		while (j < len) {
+			if (lcd_shadow_differs(LCD, addr + j, buf[j]))
+				end = ++j;
+			else if (j + 1 < len && lcd_shadow_differs(LCD, addr + j + 1, buf[j + 1]))
+				j++;
+			else
+				break;
+		}
+		j = end;
+	}
+	*i = j;
+	return start;
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t lcd_update_block (uint8_t LCD, uint8_t addr, const char* buf, uint8_t len)
+// Date : 10/16/2026
+// Version : 1.3
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function brings a block of the specified DOG LCD's DDRAM up to date with buf.
+// A shadow copy of each DOG LCD's DDRAM is kept in RAM, and buf is compared against it.
+// Only the runs of characters that changed are sent, each one as a burst that starts with
+// its own set DDRAM address command. Nothing is sent when the block is unchanged. It returns
+// the number of characters queued, so 0 means the DOG LCD already showed buf.
+//
+// Two runs separated by a single unchanged character are sent as one burst, since
+// re-sending that character costs the same as a new address command.
+//
+// With LCD_ALL the block is broadcast to every DOG LCD. A character counts as changed
+// if any DOG LCD needs it, and each changed run is sent once for all of them.
+//
+// Warnings : The shadow is only valid after init_lcd_dog or init_big_lcd_dog has cleared the
+//			  DOG LCD. Bytes written with lcd_spi_transmit_DATA bypass the shadow.
+// Restrictions : addr + len must stay inside LCD_DDRAM_SIZE
+// Algorithms : lcd_spi_write_block
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Any number of DOG LCDs share a broadcast
+//					  1.2 - Returns the number of characters queued
+//					  1.3 - Runs found by lcd_shadow_run
+//
+//**************************************************************************
+
+uint8_t lcd_update_block (uint8_t LCD, uint8_t addr, const char* buf, uint8_t len) {
+	uint8_t i = 0;
+	uint8_t sent = 0;
+
+	for (;;) {
+		uint8_t start = lcd_shadow_run(LCD, addr, buf, len, &i);
+		uint8_t end = i;
+		if (start == len) break;
+
+		lcd_spi_write_block(LCD, addr + start, &buf[start], end - start);
+		for (uint8_t j = (LCD == LCD_ALL) ? 0 : LCD; j < LCD_PANELS; j++) {
+			memcpy(&lcd_shadow[j][addr + start], &buf[start], end - start);
+			if (LCD != LCD_ALL) break;
+		}
+		sent += end - start;
+	}
+	return sent;
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t lcd_update_slices (uint8_t addr, const char* row, uint8_t len)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function brings the same block of every DOG LCD up to date with its own slice of
+// row, len characters each, LCD0's first, like lcd_update_block does for each of them.
+// The bytes for the DOG LCDs are queued in turn, one byte for each DOG LCD that has
+// anything left to send, so while one DOG LCD executes a byte the bus is busy with the
+// others, and none of them waits on the bus for a gap. It returns the number of
+// characters queued.
+//
+// Warnings : The shadow is only valid after init_lcd_dog or init_big_lcd_dog has cleared the
+//			  DOG LCDs
+// Restrictions : addr + len must stay inside LCD_DDRAM_SIZE
+// Algorithms : Round robin over the DOG LCDs
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint8_t lcd_update_slices (uint8_t addr, const char* row, uint8_t len) {
+	uint8_t next[LCD_PANELS];							// Where each DOG LCD's search for a run carries on
+	uint8_t at[LCD_PANELS];								// Next character of the run being sent to each DOG LCD
+	uint8_t end[LCD_PANELS];							// End of that run, at == end once it is all queued
+	uint8_t sent = 0;
+	uint8_t more;
+
+	memset(next, 0, sizeof(next));
+	memset(at, 0, sizeof(at));
+	memset(end, 0, sizeof(end));
+	do {
+		more = 0;
+		for (uint8_t p = 0; p < LCD_PANELS; p++) {
+			const char* buf = &row[p * len];
+			if (at[p] == end[p]) {
+				at[p] = lcd_shadow_run(p, addr, buf, len, &next[p]);
+				end[p] = next[p];
+				if (at[p] == len) continue;					// Nothing left for this DOG LCD
+				lcd_spi_enqueue(p, 0, 0x80 | (addr + at[p]), LCD_GAP_EXEC);	// set DDRAM address
+				memcpy(&lcd_shadow[p][addr + at[p]], &buf[at[p]], end[p] - at[p]);
+				sent += end[p] - at[p];
+			}
+			else
+				lcd_spi_enqueue(p, 1, buf[at[p]++], LCD_GAP_EXEC);	// send character, address counter auto-increments
+			more = 1;
+		}
+	} while (more);
+	return sent;
+}
+
+//***************************************************************************
+//
+// Function Name : void lcd_shadow_write (uint8_t LCD, uint8_t addr, const char* buf, uint8_t len)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function writes buf into the shadow copy of the specified DOG LCD's DDRAM without
+// sending anything, or into every DOG LCD's copy with LCD_ALL. It is used after the
+// characters have been sent some other way, such as by the show stream player, so the
+// next lcd_update_block compares against what the DOG LCD really shows.
+//
+// Warnings : The characters must already be on their way to the DOG LCD
+// Restrictions : addr + len must stay inside LCD_DDRAM_SIZE
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void lcd_shadow_write (uint8_t LCD, uint8_t addr, const char* buf, uint8_t len) {
+	for (uint8_t i = (LCD == LCD_ALL) ? 0 : LCD; i < LCD_PANELS; i++) {
+		memcpy(&lcd_shadow[i][addr], buf, len);
+		if (LCD != LCD_ALL) break;
+	}
+}
+
+//***************************************************************************
+//
+// Function Name : void lcd_font_mode (uint8_t big)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function switches every DOG LCD between the 3 line font and the one line double
+// height font without going through the whole power up sequence again. The steps are
+// shown below:
+// 1) Broadcasts a function set for the mode: LCD_FUNC_BIG selects 1 line, double height
+//	  and instruction table 0, so the display shift command can be used, and LCD_FUNC_3LINE
+//	  goes back to the setting init_lcd_dog leaves
+// 2) Broadcasts a clear display, which also sets the display shift back to 0
+// 3) Resets the shadow copy of every DOG LCD's DDRAM to the spaces left by the clear
+// The bias, power and contrast settings are kept, since both modes use the same ones.
+// The commands go through the transmit queue, so this function returns right away.
+//
+// Warnings : init_lcd_dog or init_big_lcd_dog must have been called first
+// Restrictions : In the big font mode the single line is LCD_LINE_SIZE characters long
+//				  and lcd_update_block must not be used
+// Algorithms : lcd_spi_enqueue
+// References : ST7036 datasheet, function set
+//
+// Revision History : Initial version
+//					  1.1 - Keeps the function set for lcd_cgram_write
+//
+//**************************************************************************
+
+void lcd_font_mode (uint8_t big) {
+	lcd_func = big ? LCD_FUNC_BIG : LCD_FUNC_3LINE;
+	lcd_spi_enqueue(LCD_ALL, 0, lcd_func, LCD_GAP_EXEC);
+	lcd_spi_enqueue(LCD_ALL, 0, 0x01, LCD_GAP_CLEAR);	// clr_display: clear display, cursor home, no shift
+	
+	memset(lcd_shadow, ' ', sizeof(lcd_shadow));	// DDRAM is filled with spaces by the clear
+}
+
+//***************************************************************************
+//
+// Function Name : void lcd_cgram_write (uint8_t LCD, uint8_t slot, uint8_t row, const uint8_t* rows, uint8_t n)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function writes n pixel rows of a character, from pixel row row down, into CGRAM
+// slot 0 to 7 of the specified DOG LCD, or of every DOG LCD with LCD_ALL. The steps are
+// shown below:
+// 1) Switches to instruction table 0 with a function set, if instruction table 1 is in
+//	  use, since 0x40 to 0x7F are the icon, power, follower and contrast commands there
+// 2) Sends the set CGRAM address command (0x40 | slot << 3 | row)
+// 3) Streams the n rows, letting the DOG LCD auto-increment the address counter
+// 4) Sends the function set the DOG LCDs were in again
+// The DDRAM cells holding character slot show the new character as soon as it lands,
+// and the next lcd_spi_write_block sets a DDRAM address again before writing. The bytes
+// go through the transmit queue, so this function returns right away.
+//
+// Warnings : init_lcd_dog or init_big_lcd_dog must have been called first
+// Restrictions : The 5 low bits of each row are the pixels, left to right, and row + n
+//				  must be 8 at most
+// Algorithms : lcd_spi_enqueue
+// References : ST7036 datasheet, set CGRAM address
+//
+// Revision History : Initial version
+//					  1.1 - Any run of pixel rows, so a character can be changed a few rows at a time
+//
+//**************************************************************************
+
+void lcd_cgram_write (uint8_t LCD, uint8_t slot, uint8_t row, const uint8_t* rows, uint8_t n) {
+	uint8_t table1 = lcd_func & LCD_FUNC_IS1;
+	
+	if (table1)
+		lcd_spi_enqueue(LCD, 0, lcd_func & ~LCD_FUNC_IS1, LCD_GAP_EXEC);	// Instruction table 0
+	lcd_spi_enqueue(LCD, 0, 0x40 | (slot << 3) | row, LCD_GAP_EXEC);	// set CGRAM address
+	for (uint8_t r = 0; r < n; r++)
+		lcd_spi_enqueue(LCD, 1, rows[r], LCD_GAP_EXEC);		// send pixel row, address counter auto-increments
+	if (table1)
+		lcd_spi_enqueue(LCD, 0, lcd_func, LCD_GAP_EXEC);
+}
+
 //***************************************************************************
 //
 // Function Name : void init_spi_lcd (void)
 // Date : 3/29/2024
-// Version : 1.0
+// Version : 1.4
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong & Kenneth Short
 //
 // This function properly sets up the registers in the SPI module to enable serial communication
 // between the AVR128DB48 and the DOG LCD. The steps for configuration are listed below:
-// 1) Set up pin directions for MOSI, MISO, SCK, /SS0 /SS1, and RS0 RS1 pins
-// 2) Sets AVR128DB48 as master, and enables SPI protocol
+// 1) Set up pin directions for MOSI, MISO, SCK, and the /SS and RS pins of every DOG LCD in lcd_panels
+// 2) Sets AVR128DB48 as master, enables SPI protocol, and sets the SCK rate and gaps for the CPU clock
 // 3) Enables SPI mode 3 (CPOL = 1, CPHA = 1) and sets data order to send MSB first
-// 4) Pulls the /SS line to high to de-select the other peripherals, and initialize RS0 and RS1 to 0 to send commands
+//	  With LCD_USART, USART0 is routed to PA4 and PA6 and put in master SPI mode instead, with
+//	  XCK inverted for CPOL = 1 and its transmitter on
+// 4) Pulls the /SS line to high to de-select the other peripherals, and initialize every RS to 0 to send commands
+// 5) Sets up TCB0 to time the execution gaps of the interrupt driven transmit queue
 //
 // Warnings : Ensure there's proper configuration of registers
 // Restrictions : none
@@ -139,180 +1095,156 @@ void lcd_spi_transmit_DATA (uint8_t LCD, unsigned char cmd) {
 // References : none
 //
 // Revision History : Initial version
+//					  1.1 - Pins taken from lcd_panels
+//					  1.2 - SCK rate from the timing profile
+//					  1.3 - Timing profile from lcd_spi_clock
+//					  1.4 - USART0 in master SPI mode
 //
 //**************************************************************************
 
 void init_spi_lcd (void) {
 	// Generic clock generator 0, enabled at reset @ 4MHz, is used for peripheral clock
 	
-	// Pin Direction Configurations & Initializations for both LCDs
+	// Pin Direction Configurations & Initializations for every LCD
 	VPORTA.DIR |= PIN4_bm | PIN6_bm; // PA4 is output for MOSI, PA5 is input for MISO, PA6 is output for SCK
-	VPORTB.DIR |= PIN0_bm | PIN1_bm; // PB0 is output for /SS0 (SS for LCD0), PB1 is output for /SS1 (SS for LCD1)
-	VPORTB.OUT |= PIN0_bm | PIN1_bm; // Idles /SS0 and /SS1 as high to de-select LCDs
-	VPORTC.DIR |= PIN0_bm | PIN1_bm; // PC0 is output for RS0 of LCD0, PC1 is output for RS1 of LCD1
+	for (uint8_t i = 0; i < LCD_PANELS; i++) {
+		lcd_panels[i].ss_port->DIR |= lcd_panels[i].ss_bm; // /SSn is an output
+		lcd_panels[i].rs_port->DIR |= lcd_panels[i].rs_bm; // RSn is an output
+	}
+	lcd_ss(LCD_ALL, 1);	// Idles every /SS line as high to de-select LCDs
 	
 	// SPI Configuration
-	SPI0.CTRLA |= SPI_MASTER_bm | SPI_ENABLE_bm; // Sets AVR128DB48 as master, and enables SPI protocol
+#if LCD_USART
+	PORTMUX.USARTROUTEA = (PORTMUX.USARTROUTEA & ~PORTMUX_USART0_gm) | PORTMUX_USART0_ALT1_gc; // TxD -> PA4, RxD -> PA5, XCK -> PA6
+	PORTA.PIN6CTRL |= PORT_INVEN_bm; // XCK idles high for CPOL = 1
+	USART0.CTRLC = USART_CMODE_MSPI_gc | USART_UCPHA_bm; // Master SPI mode with CPHA = 1, and Data order sends MSB first
+	lcd_spi_clock();	// Sets the SCK rate and the gaps for the CPU clock
+	USART0.CTRLB = USART_TXEN_bm; // Only the transmitter, the DOG LCDs don't send anything back
+#else
+	SPI0.CTRLA = SPI_MASTER_bm | SPI_ENABLE_bm; // Sets AVR128DB48 as master and enables SPI protocol
+	lcd_spi_clock();	// Sets the SCK rate and the gaps for the CPU clock
 	SPI0.CTRLB |= SPI_SSD_bm | SPI_MODE_3_gc; // Enables SPI mode 3 (CPOL = 1, CPHA = 1) and Data order sends MSB first
+#endif
 
-	VPORTC.OUT &= ~(PIN0_bm | PIN1_bm);	// RS0 = 0 and RS1 = 0 for command sends
+	lcd_rs(LCD_ALL, 0);	// Every RS = 0 for command sends
+	
+	// TCB0 Configuration
+	TCB0.CTRLB = TCB_CNTMODE_INT_gc;	// Periodic interrupt mode, used as a one-shot for the execution gaps
+	TCB0.INTCTRL = TCB_CAPT_bm;			// Interrupts when the gap has passed
 }
 
+//***************************************************************************
+//
+// Function Name : static void lcd_init_sequence (const lcd_init_t* seq, uint8_t len)
+// Date : 10/16/2026
+// Version : 1.4
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function initializes every DOG LCD together from a table of commands in flash.
+// The DOG LCDs power up at the same time, so the 40ms power up wait is shared. Each
+// command is then broadcast to every DOG LCD in one byte, and the wait that follows it
+// covers all of them, so the 200ms follower wait is also only spent once. The shadow copy of
+// each DOG LCD's DDRAM is reset to the spaces left by the clear display command.
+//
+// The commands go through the transmit queue, which leaves each one only the gap its
+// type needs: 1.08ms after the clear display and 26.3us after the rest, less the time the
+// next byte takes on the wire. The power up and follower waits are spent in sysclk_delay_ms,
+// so they are right at whatever CPU clock the DOG LCDs are initialized at. The function
+// set the table starts with is kept for lcd_cgram_write.
+//
+// Warnings : none
+// Restrictions : The first command must be the function set
+// Algorithms : lcd_spi_enqueue, lcd_spi_flush
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Any number of DOG LCDs
+//					  1.2 - Per command gaps from the timing profile instead of a blanket 30us
+//					  1.3 - Waits follow the CPU clock
+//					  1.4 - Keeps the function set
+//
+//**************************************************************************
+
+static void lcd_init_sequence (const lcd_init_t* seq, uint8_t len) {
+	init_spi_lcd();		//Initialize MCU for SPI with every LCD display
+	
+	//start_dly_40ms:
+	sysclk_delay_ms(LCD_POWER_UP_MS);	//40ms delay for every LCD display to power up
+	
+	for (uint8_t s = 0; s < len; s++) {
+		unsigned char cmd = pgm_read_byte(&seq[s].cmd);
+		lcd_spi_enqueue(LCD_ALL, 0, cmd, LCD_CMD_GAP(cmd));	// Same command to every LCD display at once
+		
+		if (pgm_read_byte(&seq[s].wait) == LCD_WAIT_FOLLOWER) {
+			lcd_spi_flush();
+			sysclk_delay_ms(LCD_FOLLOWER_MS);	//200ms delay for command to be processed
+		}
+	}
+	lcd_spi_flush();	// Waits out the clear display before the shadow is trusted
+	
+	memset(lcd_shadow, ' ', sizeof(lcd_shadow));	// DDRAM is filled with spaces by the clear
+	lcd_func = pgm_read_byte(&seq[0].cmd);
+}
+
 //***************************************************************************
 //
 // Function Name : void init_lcd_dog(void)
 // Date : 3/29/2024
-// Version : 1.0
+// Version : 1.1
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong & Kenneth Short
 //
-// This function sends serial bytes to both of the DOG LCD to configure its settings.
+// This function sends serial bytes to every DOG LCD to configure its settings.
 // Configuring the functionality of the display requires sending well timed
 // serial packets in the correct order and with the right delays.
 //
 // Warnings : Ensure serial packets for initialization are sent in the right order, 
 //			  and proper delays are used in between the sent packets.
 // Restrictions : none
-// Algorithms : lcd_spi_transmit_CMD
+// Algorithms : lcd_init_sequence
 // References : none
 //
 // Revision History : Initial version
+//					  1.1 - Both DOG LCDs are initialized together and share the waits
 //
 //**************************************************************************
 
 void init_lcd_dog (void) {
-	init_spi_lcd();		//Initialize MCU for SPI with both LCD displays
-	
-	for (uint8_t i = 0; i < 2; i++) {
-		//start_dly_40ms:
-		_delay_ms(40);	//40ms delay for command to be processed
-
-		//func_set1:
-		lcd_spi_transmit_CMD(i, 0x39);   // send function set #1
-		_delay_us(30);	//26.3us delay for command to be processed
-
-
-		//func_set2:
-		lcd_spi_transmit_CMD(i, 0x39);	//send function set #2
-		_delay_us(30);	//26.3us delay for command to be processed
-
-
-		//bias_set:
-		lcd_spi_transmit_CMD(i, 0x1E);	//set bias value.
-		_delay_us(30);	//26.3us delay for command to be processed
-
-
-		//power_ctrl:
-		lcd_spi_transmit_CMD(i, 0x55);	//~ 0x50 nominal for 5V
-		//~ 0x55 for 3.3V (delicate adjustment).
-		_delay_us(30);	//26.3us delay for command to be processed
-
-
-		//follower_ctrl:
-		lcd_spi_transmit_CMD(i, 0x6C);	//follower mode on...
-		_delay_ms(200);	//200ms delay for command to be processed
-
-
-		//contrast_set:
-		lcd_spi_transmit_CMD(i, 0x7F);	//~ 77 for 5V, ~ 7F for 3.3V
-		_delay_us(30);	//26.3us delay for command to be processed
-
-
-		//display_on:
-		lcd_spi_transmit_CMD(i, 0x0C);	//display on, cursor off, blink off
-		_delay_us(30);	//26.3us delay for command to be processed
-
-
-		//clr_display:
-		lcd_spi_transmit_CMD(i, 0x01);	//clear display, cursor home
-		_delay_us(30);	//26.3us delay for command to be processed
-
+	lcd_init_sequence(lcd_init_3line, LCD_INIT_STEPS(lcd_init_3line));
+}
 
-		//entry_mode:
-		lcd_spi_transmit_CMD(i, 0x06);	//clear display, cursor home & auto-increment
-		_delay_us(30);	//26.3us delay for command to be processed
-	
-	}	
-}
-
 //***************************************************************************
 //
 // Function Name : void init_big_lcd_dog(void)
 // Date : 3/29/2024
-// Version : 1.0
+// Version : 1.2
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong & Kenneth Short
 //
-// This function sends serial bytes to both of the DOG LCD to configure its settings.
+// This function sends serial bytes to every DOG LCD to configure its settings.
 // Configuring the functionality of the display requires sending well timed
 // serial packets in the correct order and with the right delays. This specific
 // configuration makes the display one line with a large font. The buffers can only be
-// 8 characters long (9 with null space).
+// 8 characters long (9 with null space). The function set selects instruction table 1,
+// so the bias, power, follower and contrast commands that follow are taken as such.
 //
 // Warnings : Ensure serial packets for initialization are sent in the right order, 
 //			  and proper delays are used in between the sent packets.
 // Restrictions : none
-// Algorithms : lcd_spi_transmit_CMD
+// Algorithms : lcd_init_sequence
 // References : none
 //
 // Revision History : Initial version
+//					  1.1 - Both DOG LCDs are initialized together and share the waits
+//					  1.2 - Double height and instruction table 1 in the function set
 //
 //**************************************************************************
 
 void init_big_lcd_dog (void) {
-	init_spi_lcd();		//Initialize MCU for SPI with both LCD displays
-	
-	for (uint8_t i = 0; i < 2; i++) {
-		//start_dly_40ms:
-		_delay_ms(40);	//40ms delay for command to be processed
-
-		//func_set1:
-		lcd_spi_transmit_CMD(i, 0x30);   // send function set #1
-		_delay_us(30);	//26.3us delay for command to be processed
-
-
-		//func_set2:
-		lcd_spi_transmit_CMD(i, 0x30);	//send function set #2
-		_delay_us(30);	//26.3us delay for command to be processed
-
-
-		//bias_set:
-		lcd_spi_transmit_CMD(i, 0x1E);	//set bias value.
-		_delay_us(30);	//26.3us delay for command to be processed
-
-
-		//power_ctrl:
-		lcd_spi_transmit_CMD(i, 0x55);	//~ 0x50 nominal for 5V
-		//~ 0x55 for 3.3V (delicate adjustment).
-		_delay_us(30);	//26.3us delay for command to be processed
-
-
-		//follower_ctrl:
-		lcd_spi_transmit_CMD(i, 0x6C);	//follower mode on...
-		_delay_ms(200);	//200ms delay for command to be processed
-
-
-		//contrast_set:
-		lcd_spi_transmit_CMD(i, 0x7F);	//~ 77 for 5V, ~ 7F for 3.3V
-		_delay_us(30);	//26.3us delay for command to be processed
-
-
-		//display_on:
-		lcd_spi_transmit_CMD(i, 0x0C);	//display on, cursor off, blink off
-		_delay_us(30);	//26.3us delay for command to be processed
-
-
-		//clr_display:
-		lcd_spi_transmit_CMD(i, 0x01);	//clear display, cursor home
-		_delay_us(30);	//26.3us delay for command to be processed
-
+	lcd_init_sequence(lcd_init_big, LCD_INIT_STEPS(lcd_init_big));
+}
 
-		//entry_mode:
-		lcd_spi_transmit_CMD(i, 0x06);	//clear display, cursor home & auto-increment
-		_delay_us(30);	//26.3us delay for command to be processed
-	
-	}
-}
-
@@ -18,6 +18,9 @@
 // /SS1 -> PB1
 // RS0 -> PC0
 // RS1 -> PC1
+// The /SS and RS pins of further DOG LCDs (up to 8) are listed in lcd_panels in DOGM163WA.c
+// With LCD_USART set to 1, USART0 drives the same pins in its master SPI mode instead of
+// SPI0 (TxD -> PA4, RxD -> PA5, XCK -> PA6 with the alternate pin routing).
 //
 // Warnings :
 // Restrictions : none
@@ -32,33 +35,80 @@
 #ifndef DOGM163WA_H_
 #define DOGM163WA_H_
 
-#define F_CPU 4000000LU
+// Bus the DOG LCDs are driven from
+#ifndef LCD_USART
+#define LCD_USART 0														// 0 for SPI0, 1 for USART0 in master SPI mode, with a second byte in its transmit buffer
+#endif
+
+// SPI timing profile for the DOG LCDs, worked out by lcd_spi_clock for the CPU clock in use
+#ifndef LCD_SCK_MAX_HZ
+#define LCD_SCK_MAX_HZ 2000000UL										// Fastest SCK, the smallest SPI0 divider (2 to 128) or USART0 divider (any even number) that stays at or under it is used
+#endif
+
+// ST7036 execution times, counted from the last bit of the byte
+#define LCD_EXEC_NS 26300UL												// Most instructions and every data write
+#define LCD_EXEC_CLEAR_NS 1080000UL										// Clear display and return home
+#define LCD_FOLLOWER_MS 200												// Follower circuit settling after follower control
+#define LCD_POWER_UP_MS 40												// Power up before the first command
+
+#define LCD_BYTE_TICKS(div) (8U * (div))								// TCB0 counts one byte spends on the wire, with SCK = CPU clock / div
+#define LCD_EXEC_TICKS(exec_ns, mhz) (((exec_ns) * (mhz) + 999) / 1000)	// TCB0 counts of an execution time
+
+// Gap classes for the transmit queue, the execution time a DOG LCD needs after the byte
+#define LCD_GAP_NONE 0													// The next byte can follow right away
+#define LCD_GAP_EXEC 1													// 26.3us, most instructions and data
+#define LCD_GAP_CLEAR 2													// 1.08ms, clear display and return home
+#define LCD_CMD_GAP(cmd) ((cmd) == 0x01 || ((cmd) & 0xFE) == 0x02 ? LCD_GAP_CLEAR : LCD_GAP_EXEC)
+
+// DOG LCD selection
+#ifndef LCD_PANELS
+#define LCD_PANELS 2													// DOG LCDs in the chain, LCD0 on the left, at most 8
+#endif
+#define LCD_ALL 0xFE													// Broadcast to every DOG LCD at once
+
+// DDRAM address of the first column of each row in 3 line mode
+#define LCD_ROW_ADDR(row) ((row) << 4)
+#define LCD_DDRAM_SIZE 48												// 3 rows of 16 characters
+#define LCD_COLS 16														// Characters shown on each row of the glass
+#define LCD_LINE_SIZE 80												// DDRAM characters of the single line in the big font mode
+
+// Commands used outside of the power up sequence
+#define LCD_FUNC_3LINE 0x39												// 8 bit, 3 lines, instruction table 1
+#define LCD_FUNC_BIG 0x34												// 8 bit, 1 line, double height, instruction table 0
+#define LCD_FUNC_IS1 0x01												// Function set bit that selects instruction table 1
+#define LCD_SHIFT_LEFT 0x18												// Display shift by one column to the left, instruction table 0
 
 #include <avr/io.h>
-#include <util/delay.h>
+#include "sysclk.h"
+#include <string.h>
 
 //***************************************************************************
 //
 // Function Name : void lcd_spi_transmit_CMD (uint8_t LCD, unsigned char cmd)
 // Date : 3/29/2024
-// Version : 1.0
+// Version : 1.1
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong & Kenneth Short
 // 
 // This function transmits a command character to the specified DOG LCD. The steps are shown below:
-// 1) Select the device by pulling the /SS0 or /SS1 line low
-// 2) Pull the RS0 or RS1 line to a 0 for the DOG LCD to interpret the serial byte packet as a command
+// 1) Select the device by pulling its /SS line low, or every /SS line for LCD_ALL
+// 2) Pull its RS line to a 0 for the DOG LCD to interpret the serial byte packet as a command
 // 3) Transmit the serial byte by placing cmd into the SPI data register
-// 4) Wait until the data transmission is complete by polling for the IF flag
-// 5) De-select the device by pulling the /SS0 or /SS1 line high
+// 4) Wait until the data transmission is complete and the command has been executed
+// 5) De-select the device by pulling its /SS line high
+// The steps are carried out by the transmit queue, with the gap for the command's type
+// (1.08ms for clear display and return home, 26.3us for the rest), so the caller doesn't
+// need to add a delay of its own.
 //
 // Warnings : none
-// Restrictions : none
-// Algorithms : none
+// Restrictions : The 200ms follower wait is still left to the caller
+// Algorithms : lcd_spi_enqueue, lcd_spi_flush
 // References : none
 //
 // Revision History : Initial version
+//					  1.1 - Pins taken from lcd_panels
+//					  1.2 - Waits out the execution time from the timing profile
 //
 //**************************************************************************
  
@@ -68,44 +118,350 @@ void lcd_spi_transmit_CMD (uint8_t LCD, unsigned char cmd);
 //
 // Function Name : void lcd_spi_transmit_CMD (uint8_t LCD, unsigned char cmd)
 // Date : 3/29/2024
-// Version : 1.0
+// Version : 1.1
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong & Kenneth Short
 //
 // This function transmits a data byte to the specified DOG LCD. The steps are shown below:
-// 1) Select the device by pulling the /SS0 or /SS1 line low
-// 2) Pull the RS0 or RS1 line to a 0 for the DOG LCD to interpret the serial byte packet as a data
+// 1) Select the device by pulling its /SS line low, or every /SS line for LCD_ALL
+// 2) Pull its RS line to a 1 for the DOG LCD to interpret the serial byte packet as a data
 // 3) Transmit the serial byte by placing cmd into the SPI data register
-// 4) Wait until the data transmission is complete by polling for the IF flag
-// 5) De-select the device by pulling the /SS0 or /SS1 line high
+// 4) Wait until the data transmission is complete and the 26.3us write has finished
+// 5) De-select the device by pulling its /SS line high
+// The steps are carried out by the transmit queue, so the caller doesn't need to add a
+// delay of its own.
 //
 // Warnings : none
 // Restrictions : none
-// Algorithms : none
+// Algorithms : lcd_spi_enqueue, lcd_spi_flush
 // References : none
 //
 // Revision History : Initial version
+//					  1.1 - Pins taken from lcd_panels
+//					  1.2 - Waits out the execution time from the timing profile
 //
 //**************************************************************************
 
 void lcd_spi_transmit_DATA (uint8_t LCD, unsigned char cmd);
 
+//***************************************************************************
+//
+// Function Name : void lcd_spi_enqueue (uint8_t LCD, uint8_t rs, unsigned char byte, uint8_t gap)
+// Date : 10/16/2026
+// Version : 1.2
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function places a byte on the interrupt driven transmit queue and returns
+// without waiting for it to be sent. Each entry holds the DOG LCD to select, the RS level,
+// the serial byte and the gap class to leave after it. LCD_ALL broadcasts the byte. The SPI0 and TCB0
+// interrupts switch /SS and RS, send the byte and time the gap in the background.
+// If the queue is full, this function waits until there is room. With LCD_USART, a byte
+// that can follow the one in flight with no gap is put into the USART0 transmit buffer
+// while that one is still shifted out.
+//
+// Warnings : Called with interrupts disabled, the queue is drained by polling instead
+// Restrictions : gap must be LCD_GAP_NONE, LCD_GAP_EXEC or LCD_GAP_CLEAR. LCD_CMD_GAP gives
+//				  the class for a command. The 200ms follower wait goes through sysclk_delay_ms,
+//				  which follows the clock in use, not through the queue.
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - gap is a class from the timing profile instead of a time in us
+//					  1.2 - Fills the USART0 transmit buffer
+//
+//**************************************************************************
+
+void lcd_spi_enqueue (uint8_t LCD, uint8_t rs, unsigned char byte, uint8_t gap);
+
+//***************************************************************************
+//
+// Function Name : void lcd_spi_flush (void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function waits until every queued byte has been sent and its execution gap
+// has passed, and every DOG LCD is de-selected.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void lcd_spi_flush (void);
+
+//***************************************************************************
+//
+// Function Name : void lcd_spi_clock (void) & uint8_t lcd_spi_idle (void)
+// Date : 10/16/2026
+// Version : 1.3
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// lcd_spi_clock works out the SPI timing profile for the CPU clock set in sysclk. The
+// steps are shown below:
+// 1) Picks the smallest SPI0 divider that keeps SCK at or under LCD_SCK_MAX_HZ, or with
+//	  LCD_USART the smallest even USART0 divider, which can get much closer to it
+// 2) Sets the SPI0 prescaler and CLK2X bits, or the USART0 BAUD register, for that divider
+// 3) Works out the TCB0 counts of the ST7036 execution time of each gap class, and of
+//	  the time a byte spends on the wire at the new SCK rate
+// lcd_spi_idle returns 1 once every queued byte has been sent and its gap has passed,
+// which is when the CPU clock can be changed.
+//
+// Warnings : Call lcd_spi_clock only while lcd_spi_idle, right after every change of the CPU clock
+// Restrictions : none
+// Algorithms : LCD_BYTE_TICKS, LCD_EXEC_TICKS
+// References : ST7036 datasheet, execution times
+//
+// Revision History : Initial version
+//					  1.1 - Counts of the whole execution times
+//					  1.2 - USART0 divider
+//					  1.3 - Execution times and byte time kept apart, for the time left on each DOG LCD
+//
+//**************************************************************************
+
+void lcd_spi_clock (void);
+
+uint8_t lcd_spi_idle (void);
+
+//***************************************************************************
+//
+// Function Name : void lcd_spi_notify (void (*fn)(void))
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function arranges for fn to be called once the last byte queued so far has
+// been shifted out to its DOG LCD, which is when a frame queued just before becomes
+// visible. If the queue is already empty, fn is called right away. Only one callback
+// can be pending, a new one replaces the old one.
+//
+// Warnings : fn usually runs inside the SPI0 interrupt and must be short
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void lcd_spi_notify (void (*fn)(void));
+
+//***************************************************************************
+//
+// Function Name : void lcd_spi_write_block (uint8_t LCD, uint8_t addr, const char* buf, uint8_t len)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function places a block of characters for the DDRAM of the specified DOG LCD on
+// the transmit queue, to be sent as a single burst. The steps are shown below:
+// 1) Queue the set DDRAM address command (0x80 | addr) with RS low and LCD_GAP_EXEC
+// 2) Queue all len characters with RS high and LCD_GAP_EXEC, letting the DOG LCD
+//	  auto-increment the address counter after every character
+// The queue's interrupts pull the /SS line of the DOG LCD low, or every /SS line for
+// LCD_ALL, switch RS and send the bytes in the background. Each byte is only padded by the
+// part of the execution time that the transfer itself did not already cover.
+//
+// Warnings : buf is copied into the queue at once but sent later, so the DOG LCD doesn't
+//			  show it yet when this function returns. The entry mode must be set to
+//			  auto-increment (0x06), which init_lcd_dog does
+// Restrictions : addr + len must stay inside the 48 character DDRAM used in 3 line mode
+// Algorithms : lcd_spi_enqueue
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Header describes the queued transfer
+//
+//**************************************************************************
+
+void lcd_spi_write_block (uint8_t LCD, uint8_t addr, const char* buf, uint8_t len);
+
+//***************************************************************************
+//
+// Function Name : uint8_t lcd_update_block (uint8_t LCD, uint8_t addr, const char* buf, uint8_t len)
+// Date : 10/16/2026
+// Version : 1.3
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function brings a block of the specified DOG LCD's DDRAM up to date with buf.
+// A shadow copy of each DOG LCD's DDRAM is kept in RAM, and buf is compared against it.
+// Only the runs of characters that changed are sent, each one as a burst that starts with
+// its own set DDRAM address command. Nothing is sent when the block is unchanged. It returns
+// the number of characters queued, so 0 means the DOG LCD already showed buf.
+// With LCD_ALL the block is broadcast to every DOG LCD. A character counts as changed
+// if any DOG LCD needs it, and each changed run is sent once for all of them.
+//
+// Warnings : The shadow is only valid after init_lcd_dog or init_big_lcd_dog has cleared the
+//			  DOG LCD. Bytes written with lcd_spi_transmit_DATA bypass the shadow.
+// Restrictions : addr + len must stay inside LCD_DDRAM_SIZE
+// Algorithms : lcd_spi_write_block
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Any number of DOG LCDs share a broadcast
+//					  1.2 - Returns the number of characters queued
+//					  1.3 - Runs found by lcd_shadow_run
+//
+//**************************************************************************
+
+uint8_t lcd_update_block (uint8_t LCD, uint8_t addr, const char* buf, uint8_t len);
+
+//***************************************************************************
+//
+// Function Name : uint8_t lcd_update_slices (uint8_t addr, const char* row, uint8_t len)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function brings the same block of every DOG LCD up to date with its own slice of
+// row, len characters each, LCD0's first, like lcd_update_block does for each of them.
+// The bytes for the DOG LCDs are queued in turn, one byte for each DOG LCD that has
+// anything left to send, so while one DOG LCD executes a byte the bus is busy with the
+// others, and none of them waits on the bus for a gap. It returns the number of
+// characters queued.
+//
+// Warnings : The shadow is only valid after init_lcd_dog or init_big_lcd_dog has cleared the
+//			  DOG LCDs
+// Restrictions : addr + len must stay inside LCD_DDRAM_SIZE
+// Algorithms : Round robin over the DOG LCDs
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint8_t lcd_update_slices (uint8_t addr, const char* row, uint8_t len);
+
+//***************************************************************************
+//
+// Function Name : void lcd_shadow_write (uint8_t LCD, uint8_t addr, const char* buf, uint8_t len)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function writes buf into the shadow copy of the specified DOG LCD's DDRAM without
+// sending anything, or into every DOG LCD's copy with LCD_ALL. It is used after the
+// characters have been sent some other way, such as by the show stream player, so the
+// next lcd_update_block compares against what the DOG LCD really shows.
+//
+// Warnings : The characters must already be on their way to the DOG LCD
+// Restrictions : addr + len must stay inside LCD_DDRAM_SIZE
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void lcd_shadow_write (uint8_t LCD, uint8_t addr, const char* buf, uint8_t len);
+
+//***************************************************************************
+//
+// Function Name : void lcd_font_mode (uint8_t big)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function switches every DOG LCD between the 3 line font and the one line double
+// height font without going through the whole power up sequence again. The steps are
+// shown below:
+// 1) Broadcasts a function set for the mode: LCD_FUNC_BIG selects 1 line, double height
+//	  and instruction table 0, so the display shift command can be used, and LCD_FUNC_3LINE
+//	  goes back to the setting init_lcd_dog leaves
+// 2) Broadcasts a clear display, which also sets the display shift back to 0
+// 3) Resets the shadow copy of every DOG LCD's DDRAM to the spaces left by the clear
+// The bias, power and contrast settings are kept, since both modes use the same ones.
+// The commands go through the transmit queue, so this function returns right away.
+//
+// Warnings : init_lcd_dog or init_big_lcd_dog must have been called first
+// Restrictions : In the big font mode the single line is LCD_LINE_SIZE characters long
+//				  and lcd_update_block must not be used
+// Algorithms : lcd_spi_enqueue
+// References : ST7036 datasheet, function set
+//
+// Revision History : Initial version
+//					  1.1 - Keeps the function set for lcd_cgram_write
+//
+//**************************************************************************
+
+void lcd_font_mode (uint8_t big);
+
+//***************************************************************************
+//
+// Function Name : void lcd_cgram_write (uint8_t LCD, uint8_t slot, uint8_t row, const uint8_t* rows, uint8_t n)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function writes n pixel rows of a character, from pixel row row down, into CGRAM
+// slot 0 to 7 of the specified DOG LCD, or of every DOG LCD with LCD_ALL. The steps are
+// shown below:
+// 1) Switches to instruction table 0 with a function set, if instruction table 1 is in
+//	  use, since 0x40 to 0x7F are the icon, power, follower and contrast commands there
+// 2) Sends the set CGRAM address command (0x40 | slot << 3 | row)
+// 3) Streams the n rows, letting the DOG LCD auto-increment the address counter
+// 4) Sends the function set the DOG LCDs were in again
+// The DDRAM cells holding character slot show the new character as soon as it lands,
+// and the next lcd_spi_write_block sets a DDRAM address again before writing. The bytes
+// go through the transmit queue, so this function returns right away.
+//
+// Warnings : init_lcd_dog or init_big_lcd_dog must have been called first
+// Restrictions : The 5 low bits of each row are the pixels, left to right, and row + n
+//				  must be 8 at most
+// Algorithms : lcd_spi_enqueue
+// References : ST7036 datasheet, set CGRAM address
+//
+// Revision History : Initial version
+//					  1.1 - Any run of pixel rows, so a character can be changed a few rows at a time
+//
+//**************************************************************************
+
+void lcd_cgram_write (uint8_t LCD, uint8_t slot, uint8_t row, const uint8_t* rows, uint8_t n);
+
 //***************************************************************************
 //
 // Function Name : void init_spi_lcd (void)
 // Date : 3/29/2024
-// Version : 1.0
+// Version : 1.4
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong & Kenneth Short
 //
 // This function properly sets up the registers in the SPI module to enable serial communication
 // between the AVR128DB48 and the DOG LCD. The steps for configuration are listed below:
-// 1) Set up pin directions for MOSI, MISO, SCK, /SS0 /SS1, and RS0 RS1 pins
-// 2) Sets AVR128DB48 as master, and enables SPI protocol
+// 1) Set up pin directions for MOSI, MISO, SCK, and the /SS and RS pins of every DOG LCD in lcd_panels
+// 2) Sets AVR128DB48 as master, enables SPI protocol, and sets the SCK rate and gaps for the CPU clock
 // 3) Enables SPI mode 3 (CPOL = 1, CPHA = 1) and sets data order to send MSB first
-// 4) Pulls the /SS line to high to de-select the other peripherals, and initialize RS0 and RS1 to 0 to send commands
+//	  With LCD_USART, USART0 is routed to PA4 and PA6 and put in master SPI mode instead, with
+//	  XCK inverted for CPOL = 1 and its transmitter on
+// 4) Pulls the /SS line to high to de-select the other peripherals, and initialize every RS to 0 to send commands
+// 5) Sets up TCB0 to time the execution gaps of the interrupt driven transmit queue
 //
 // Warnings : Ensure there's proper configuration of registers
 // Restrictions : none
@@ -113,6 +469,10 @@ void lcd_spi_transmit_DATA (uint8_t LCD, unsigned char cmd);
 // References : none
 //
 // Revision History : Initial version
+//					  1.1 - Pins taken from lcd_panels
+//					  1.2 - SCK rate from the timing profile
+//					  1.3 - Timing profile from lcd_spi_clock
+//					  1.4 - USART0 in master SPI mode
 //
 //**************************************************************************
 
@@ -122,22 +482,23 @@ void init_spi_lcd (void);
 //
 // Function Name : void init_lcd_dog(void)
 // Date : 3/29/2024
-// Version : 1.0
+// Version : 1.1
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong & Kenneth Short
 //
-// This function sends serial bytes to both of the DOG LCD to configure its settings.
+// This function sends serial bytes to every DOG LCD to configure its settings.
 // Configuring the functionality of the display requires sending well timed
 // serial packets in the correct order and with the right delays.
 //
 // Warnings : Ensure serial packets for initialization are sent in the right order,
 //			  and proper delays are used in between the sent packets.
 // Restrictions : none
-// Algorithms : lcd_spi_transmit_CMD
+// Algorithms : lcd_init_sequence
 // References : none
 //
 // Revision History : Initial version
+//					  1.1 - Both DOG LCDs are initialized together and share the waits
 //
 //**************************************************************************
 
@@ -147,24 +508,27 @@ void init_lcd_dog (void);
 //
 // Function Name : void init_big_lcd_dog(void)
 // Date : 3/29/2024
-// Version : 1.0
+// Version : 1.2
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong & Kenneth Short
 //
-// This function sends serial bytes to both of the DOG LCD to configure its settings.
+// This function sends serial bytes to every DOG LCD to configure its settings.
 // Configuring the functionality of the display requires sending well timed
 // serial packets in the correct order and with the right delays. This specific
 // configuration makes the display one line with a large font. The buffers can only be
-// 8 characters long (9 with null space).
+// 8 characters long (9 with null space). The function set selects instruction table 1,
+// so the bias, power, follower and contrast commands that follow are taken as such.
 //
 // Warnings : Ensure serial packets for initialization are sent in the right order, 
 //			  and proper delays are used in between the sent packets.
 // Restrictions : none
-// Algorithms : lcd_spi_transmit_CMD
+// Algorithms : lcd_init_sequence
 // References : none
 //
 // Revision History : Initial version
+//					  1.1 - Both DOG LCDs are initialized together and share the waits
+//					  1.2 - Double height and instruction table 1 in the function set
 //
 //**************************************************************************
 
@@ -0,0 +1,281 @@
+//***************************************************************************
+//
+// File Name : events.c
+// Title :
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This file defines the event queue, the RTC time stamps and the PB2 pushbutton
+// interrupt. The interrupt keeps its work to a minimum so that it never holds up
+// the SPI transmit queue or the scroll timer.
+//
+// Warnings :
+// Restrictions : none
+// Algorithms : none
+// References :
+//
+// Revision History : Initial version
+//
+//
+//**************************************************************************
+
+#include <avr/interrupt.h>
+
+#include "events.h"
+
+static event_t event_queue[EVENT_QUEUE_SIZE];
+static volatile uint8_t event_head;					// Next free entry, only written by the ISR
+static volatile uint8_t event_tail;					// Next event to handle, only written by the main loop
+
+static volatile uint16_t clock_high;				// Upper 16 bits of the time stamp clock
+static uint32_t button_edge;						// Time stamp of the last edge that was not bounce
+static uint32_t button_down;						// Time stamp of the last press
+static uint8_t button_held;							// 1 from an accepted press until its release
+
+static uint16_t tick_period;						// RTC ticks between calls to tick_fn
+static void (*tick_fn)(void);
+
+//***************************************************************************
+//
+// Function Name : void init_events(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function sets up the time stamp clock and the pushbutton. The steps are shown below:
+// 1) Runs the RTC from the internal 32.768kHz oscillator with an overflow interrupt,
+//	  which extends the 16 bit count to 32 bits
+// 2) Configures PB2 as an input that interrupts on both edges, so long presses can be timed
+// 3) Clears the Interrupt flag on PB2
+//
+// Warnings : Global interrupts must be enabled for events to be posted
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void init_events(void) {
+	while (RTC.STATUS) {}								// Waits for the RTC to be ready for new settings
+	RTC.CLKSEL = RTC_CLKSEL_OSC32K_gc;					// Internal 32.768kHz oscillator
+	RTC.PER = 0xFFFF;
+	RTC.INTCTRL = RTC_OVF_bm;							// Interrupts on overflow to count the upper 16 bits
+	RTC.CTRLA = RTC_PRESCALER_DIV1_gc | RTC_RUNSTDBY_bm | RTC_RTCEN_bm;
+	
+	PORTB.DIRCLR = PIN2_bm;								// Configures PB2 (On-board active low pushbutton) as an input
+	PORTB.PIN2CTRL = (PORTB.PIN2CTRL & ~PORT_ISC_gm) | PORT_ISC_BOTHEDGES_gc;	// Enables Interrupt on both edges
+	PORTB.INTFLAGS = PIN2_bm;							// Clears the Interrupt flag on PB2
+}
+
+//***************************************************************************
+//
+// Function Name : uint32_t clock_ticks(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns the time since init_events in RTC ticks (CLOCK_HZ per second).
+// If the count has overflowed but the overflow interrupt has not run yet, the upper
+// half is corrected here so the time stamp never steps backwards.
+//
+// Warnings : none
+// Restrictions : Wraps around after about 36 hours
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint32_t clock_ticks(void) {
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t high = clock_high;
+	uint16_t low = RTC.CNT;
+	if ((RTC.INTFLAGS & RTC_OVF_bm) && low < 0x8000)	// Overflow is pending and low is past it
+		high++;
+	SREG = sreg;
+	return ((uint32_t)high << 16) | low;
+}
+
+//***************************************************************************
+//
+// Function Name : static void event_post(uint8_t type, uint32_t time)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function places an event on the queue. If the queue is full the event is
+// dropped, since the main loop is already behind on button presses.
+//
+// Warnings : Must be called with interrupts disabled
+//
+//**************************************************************************
+
+static void event_post(uint8_t type, uint32_t time) {
+	uint8_t next = (event_head + 1) & (EVENT_QUEUE_SIZE - 1);
+	if (next == event_tail)
+		return;
+	event_queue[event_head].type = type;
+	event_queue[event_head].time = time;
+	event_head = next;
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t event_get(event_t* event) & uint8_t event_pending(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// event_get takes the oldest event off the queue and returns 1, or returns 0 if the
+// queue is empty. event_pending returns 1 if an event is waiting, which the main loop
+// checks with interrupts disabled right before going to sleep.
+//
+// Warnings : Only the main loop may take events off the queue
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint8_t event_get(event_t* event) {
+	if (event_tail == event_head)
+		return 0;
+	uint8_t sreg = SREG;
+	cli();
+	*event = event_queue[event_tail];
+	SREG = sreg;
+	event_tail = (event_tail + 1) & (EVENT_QUEUE_SIZE - 1);
+	return 1;
+}
+
+uint8_t event_pending(void) {
+	return event_tail != event_head;
+}
+
+//***************************************************************************
+//
+// Function Name : void tick_start(uint16_t period, void (*tick)(void)) & void tick_stop(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// tick_start calls tick from the RTC interrupt every period RTC ticks, the first time
+// one period from now. The RTC compare channel is moved ahead by period on every tick,
+// so the ticks keep exact time on the 32.768kHz oscillator whatever the CPU clock is
+// set to. Calling tick_start again restarts the ticks. tick_stop ends them.
+//
+// Warnings : tick runs inside the RTC interrupt and must be short
+// Restrictions : One tick source at a time, init_events must have been called
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void tick_start(uint16_t period, void (*tick)(void)) {
+	uint8_t sreg = SREG;
+	cli();
+	tick_period = period;
+	tick_fn = tick;
+	while (RTC.STATUS & RTC_CMPBUSY_bm) {}				// Waits for the last compare value to be synchronized
+	RTC.CMP = RTC.CNT + period;							// Wraps with the count, since PER is 0xFFFF
+	RTC.INTFLAGS = RTC_CMP_bm;							// Clears the Interrupt flag
+	RTC.INTCTRL |= RTC_CMP_bm;							// Enables Interrupt on compare match
+	SREG = sreg;
+}
+
+void tick_stop(void) {
+	uint8_t sreg = SREG;
+	cli();
+	RTC.INTCTRL &= ~RTC_CMP_bm;
+	RTC.INTFLAGS = RTC_CMP_bm;
+	tick_fn = 0;
+	SREG = sreg;
+}
+
+//***************************************************************************
+//
+// Function Name : ISR (PORTB_PORT_vect) & ISR (RTC_CNT_vect)
+// Date : 10/16/2026
+// Version : 1.2
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// The PORTB interrupt time stamps each edge on PB2 and drops edges that come
+// within DEBOUNCE_TICKS of the last accepted one. An accepted edge compares the level
+// of PB2 with button_held, the state latched by the last press, instead of trusting
+// the direction of the edge:
+// Low, not held -> A press, which posts EVENT_PRESS
+// High, held -> The release, which posts EVENT_HOLD if the pushbutton was held for
+//				 HOLD_TICKS or longer
+// Low, held -> The release was dropped as bounce, which only happens within
+//				DEBOUNCE_TICKS of the press, so it wasn't a long press. This is a new press
+// High, not held -> The press was dropped as bounce, so nothing is posted
+// The RTC interrupt counts the upper 16 bits of the time stamp clock on an overflow,
+// and calls the tick function of tick_start on a compare match.
+//
+// Revision History : Initial version
+//					  1.1 - Compare match ticks for tick_start
+//					  1.2 - Level of PB2 compared with the latched state, so a release
+//							lost to the debounce can't post EVENT_HOLD later
+//
+//**************************************************************************
+
+ISR (PORTB_PORT_vect) {
+	uint32_t now = clock_ticks();
+	uint8_t released = PORTB.IN & PIN2_bm;				// Active low, a high level means released
+	
+	PORTB.INTFLAGS = PIN2_bm;							// Clears the Interrupt flag
+	
+	if (now - button_edge < DEBOUNCE_TICKS)
+		return;
+	button_edge = now;
+	
+	if (!released) {									// A press, or a new one after a release that was dropped
+		button_down = now;
+		button_held = 1;
+		event_post(EVENT_PRESS, now);
+	}
+	else if (button_held) {
+		button_held = 0;
+		if (now - button_down >= HOLD_TICKS)
+			event_post(EVENT_HOLD, now);
+	}
+}
+
+ISR (RTC_CNT_vect) {
+	uint8_t flags = RTC.INTFLAGS;
+	
+	if (flags & RTC_OVF_bm) {
+		clock_high++;
+		RTC.INTFLAGS = RTC_OVF_bm;						// Clears the Interrupt flag
+	}
+	
+	if ((flags & RTC_CMP_bm) && (RTC.INTCTRL & RTC_CMP_bm)) {
+		RTC.INTFLAGS = RTC_CMP_bm;						// Clears the Interrupt flag
+		while (RTC.STATUS & RTC_CMPBUSY_bm) {}
+		RTC.CMP += tick_period;							// Next tick, one period after this one
+		tick_fn();
+	}
+}
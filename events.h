@@ -0,0 +1,152 @@
+//***************************************************************************
+//
+// File Name : events.h
+// Title :
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This header file declares the event queue that connects the interrupts to the
+// main loop, and the RTC based time stamps used to debounce the pushbutton.
+// The PB2 pushbutton interrupt only debounces and time stamps the press and
+// posts an event. The main loop takes the events off the queue and acts on them.
+//
+// The pushbutton is connected as follows:
+// PB2 -> On-board active low pushbutton
+//
+// Warnings :
+// Restrictions : none
+// Algorithms : none
+// References :
+//
+// Revision History : Initial version
+//
+//
+//**************************************************************************
+
+#ifndef EVENTS_H_
+#define EVENTS_H_
+
+#include <avr/io.h>
+
+#define CLOCK_HZ 32768UL							// RTC time stamp rate, from the internal 32.768kHz oscillator
+#define CLOCK_US(ticks) ((uint32_t)(ticks) * 15625UL / 512)	// Converts time stamp ticks to us
+#define DEBOUNCE_TICKS (CLOCK_HZ * 50 / 1000)		// Edges within 50ms of the last one are bounce
+#define HOLD_TICKS CLOCK_HZ							// Holding the pushbutton for 1s is a long press
+#define EVENT_QUEUE_SIZE 8							// Must be a power of 2
+
+// Event types
+#define EVENT_PRESS 1								// Pushbutton pressed
+#define EVENT_HOLD 2								// Pushbutton released after a long press
+
+typedef struct {
+	uint8_t type;
+	uint32_t time;									// Time stamp of the edge, in RTC ticks
+} event_t;
+
+//***************************************************************************
+//
+// Function Name : void init_events(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function sets up the time stamp clock and the pushbutton. The steps are shown below:
+// 1) Runs the RTC from the internal 32.768kHz oscillator with an overflow interrupt,
+//	  which extends the 16 bit count to 32 bits
+// 2) Configures PB2 as an input that interrupts on both edges, so long presses can be timed
+// 3) Clears the Interrupt flag on PB2
+//
+// Warnings : Global interrupts must be enabled for events to be posted
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void init_events(void);
+
+//***************************************************************************
+//
+// Function Name : uint32_t clock_ticks(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns the time since init_events in RTC ticks (CLOCK_HZ per second).
+// It can be called with interrupts enabled or disabled, including from an ISR.
+//
+// Warnings : none
+// Restrictions : Wraps around after about 36 hours
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint32_t clock_ticks(void);
+
+//***************************************************************************
+//
+// Function Name : uint8_t event_get(event_t* event) & uint8_t event_pending(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// event_get takes the oldest event off the queue and returns 1, or returns 0 if the
+// queue is empty. event_pending returns 1 if an event is waiting, which the main loop
+// checks with interrupts disabled right before going to sleep.
+//
+// Warnings : Only the main loop may take events off the queue
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint8_t event_get(event_t* event);
+
+uint8_t event_pending(void);
+
+//***************************************************************************
+//
+// Function Name : void tick_start(uint16_t period, void (*tick)(void)) & void tick_stop(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// tick_start calls tick from the RTC interrupt every period RTC ticks, the first time
+// one period from now. The RTC compare channel is moved ahead by period on every tick,
+// so the ticks keep exact time on the 32.768kHz oscillator whatever the CPU clock is
+// set to. Calling tick_start again restarts the ticks. tick_stop ends them.
+//
+// Warnings : tick runs inside the RTC interrupt and must be short
+// Restrictions : One tick source at a time, init_events must have been called
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void tick_start(uint16_t period, void (*tick)(void));
+
+void tick_stop(void);
+
+
+#endif /* EVENTS_H_ */
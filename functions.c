@@ -21,353 +21,1199 @@
 //
 //**************************************************************************
 
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
 #include "functions.h"
 #include "DOGM163WA.h"
+#include "events.h"
+#include "layout.h"
+#include "layout_rows.h"
+#include "glyph.h"
 
-int lcd0_row = 0;
-int lcd1_row = 0;
-
+#define CANVAS_COLS (LCD_PANELS * LCD_COLS)						// One canvas row across every DOG LCD
+
+#if LAYOUT_STREAM
+#define LAYOUT_RING (3 + LAYOUT_LOOKAHEAD)						// Rows kept in RAM: the frame shown and the lookahead
+
+static layout_t layout;											// Where the next row comes from in layout_source
+static char layout_ring[LAYOUT_RING][CANVAS_COLS];				// Canvas row r is kept in layout_ring[r % LAYOUT_RING]
+static uint8_t layout_text;										// Bit n is set if layout_ring[n] has text on it
+static uint16_t layout_first;									// First row in the ring since the last seek
+static uint16_t layout_end;										// Rows laid out at least once
+
+static layout_mark_t layout_index[LAYOUT_INDEX_SIZE];			// Checkpoint i is at the start of row i * layout_step
+static uint8_t layout_marks;									// Checkpoints in layout_index
+static uint16_t layout_step;									// Rows between checkpoints, doubled each time layout_index fills up
+static uint16_t layout_section_row[LAYOUT_SECTIONS];			// First row of each section reached so far
+static uint8_t layout_sections;									// Sections in layout_section_row
+
+_Static_assert(LAYOUT_RING <= 8, "layout_text has one bit per ring row");
+_Static_assert(LAYOUT_INDEX_SIZE >= 2 && !(LAYOUT_INDEX_SIZE & 1), "layout_index is halved when it fills up");
+#elif LAYOUT_PANELS != LCD_PANELS
+#error "layout_rows.h was generated for a different number of DOG LCDs, run layout_gen with LCD_PANELS"
+#endif
+
+#if SCROLL_SHOW && LAYOUT_STREAM && LAYOUT_PANELS != LCD_PANELS
+#error "the show stream in layout_rows.h was generated for a different number of DOG LCDs, run layout_gen with LCD_PANELS"
+#endif
+#if SCROLL_SHOW && SCROLL_SMOOTH
+#error "the show stream only holds the row steps of the down scroll, SCROLL_SHOW can't be used with SCROLL_SMOOTH"
+#endif
+
+#if SCROLL_SMOOTH
+#define SCROLL_STEPS GLYPH_ROWS									// Ticks per row, one pixel line each
+#else
+#define SCROLL_STEPS 1
+#endif
+#define SCROLL_TICKS (CLOCK_HZ * SCROLLSPEED / 1000 / SCROLL_STEPS)	// RTC ticks per step
+
+_Static_assert(SCROLL_TICKS <= 0xFFFF, "a step must fit in one turn of the RTC");
+_Static_assert(SCROLLHOLD / SCROLLSPEED * SCROLL_STEPS <= 0xFF, "scroll_hold counts the steps of the hold");
+#if SCROLL_SMOOTH && LAYOUT_STREAM
+_Static_assert(LAYOUT_RING >= 4, "display_slide needs 4 rows in layout_ring at once");
+#endif
+
+#define CANVAS_NONE 0xFFFF										// No such row
+
+// States of the scroll engine
+#define SCROLL_IDLE 0
+#define SCROLL_RUN 1											// Advancing one row per tick
+#define SCROLL_HOLD 2											// Holding the last frame before stopping
+#define SCROLL_PAUSE 3											// Showing a frame until told to move
+
+static volatile uint8_t scroll_ticks;							// Ticks from the RTC not yet handled
+static uint8_t scroll_state = SCROLL_IDLE;
+static uint16_t scroll_row;										// Top row of the frame shown
+static uint8_t scroll_line;										// Steps the frame has moved on from scroll_row
+static uint8_t scroll_hold;										// Ticks left in the final hold
+static uint8_t still_dirty = 1;									// The still display must be drawn again
+
+#if SCROLL_SHOW
+static uint16_t show_top = CANVAS_NONE;							// Top row of the frame on the DOG LCDs, CANVAS_NONE if they show something else
+static uint8_t show_stale;										// The show stream has changed the DOG LCDs since lcd_shadow was brought up to date
+#endif
+
+#define MARQUEE_TICKS (CLOCK_HZ * MARQUEE_SPEED / 1000)			// RTC ticks per column
+
+#if MARQUEE_GLYPHS
+#define MARQUEE_END (-GLYPH_TEXT_COLS((int16_t)sizeof(MARQUEE_TEXT) - 1))	// Column of the first character once the text has left LCD0
+
+static int16_t marquee_x;										// Canvas column of the first big character
+#else
+#define MARQUEE_COL (LCD_PANELS * LCD_COLS % LCD_LINE_SIZE)		// Line column the text starts at, just off the last DOG LCD while the chain is narrower than the line
+
+_Static_assert(MARQUEE_COL + sizeof(MARQUEE_TEXT) - 1 <= LCD_LINE_SIZE, "MARQUEE_TEXT doesn't fit in the line");
+#endif
+
+static volatile uint8_t marquee_ticks;							// Ticks from the RTC not yet handled
+static uint8_t marquee_on;
+static uint8_t press_from_still;								// The last press came while the still display was shown
+
+loop_stats_t loop_stats;
+
+volatile press_latency_t press_latency;
+static uint32_t press_time;										// Time stamp of the press being measured
+
+#if LAYOUT_STREAM
 //***************************************************************************
 //
-// Function Name : void still_display(void)
-// Date : 3/29/2024
+// Function Name : static void index_add(void)
+// Date : 10/16/2026
 // Version : 1.0
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// This function updates the text shown on both the DOG LCDs. This function uses both of the
-// SPI transmit functions written above to send the proper information. First, an address
-// is sent to let the DOG LCD know which line it's writing in. Then, a for-loop is used to transmit
-// all of the bytes in the display buffers. This step is repeated for all of the 3 lines and buffers.
+// This function saves a checkpoint of the layout, which is at the start of row
+// layout_marks * layout_step. When layout_index is full, every other checkpoint is
+// dropped and layout_step doubles, so the index stays the same size however long the
+// content is, and a row is never more than layout_step rows from a checkpoint.
 //
-// Warnings : Ensure that the 3 line buffers are populated with 17 total characters
-// Restrictions : none
-// Algorithms : init_spi_lcd, lcd_spi_transmit_CMD, lcd_spi_transmit_DATA
-// References : none
+//**************************************************************************
+
+static void index_add(void) {
+	if (layout_marks == LAYOUT_INDEX_SIZE) {
+		for (uint8_t i = 1; i < LAYOUT_INDEX_SIZE / 2; i++)
+			layout_index[i] = layout_index[2 * i];
+		layout_marks = LAYOUT_INDEX_SIZE / 2;
+		layout_step *= 2;
+	}
+	layout_mark(&layout, &layout_index[layout_marks++]);
+}
+#endif
+
+//***************************************************************************
+//
+// Function Name : static const char* canvas_row(uint16_t r, char* buf)
+// Date : 10/16/2026
+// Version : 1.2
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns canvas row r, CANVAS_COLS characters. With LAYOUT_STREAM the rows
+// are laid out from layout_source as they are asked for, and only the last LAYOUT_RING of
+// them are kept. The first time the rows are laid out, a checkpoint is saved every
+// layout_step rows and the first row of each section is noted. A row that is no longer in
+// the ring, or that is past a checkpoint ahead of the layout, is laid out again from the
+// last checkpoint at or before it, which takes at most layout_step rows. Every row laid
+// out is counted in loop_stats. Without LAYOUT_STREAM, the row is copied out of the flash
+// row table into buf.
 //
 // Revision History : Initial version
+//					  1.1 - Seeks to the nearest checkpoint instead of starting over
+//					  1.2 - Counts the rows laid out
 //
-//**************************************************************************
+//**************************************************************************
 
-void still_display(void) {
+static const char* canvas_row(uint16_t r, char* buf) {
+#if LAYOUT_STREAM
+	(void)buf;													// The row is returned from layout_ring instead
 	
-	for (uint8_t i = 0; i < 2; i++) {							// Loop to write left/right LCD display
-		init_spi_lcd();
-		lcd_spi_transmit_CMD(i, 0x80);							// init DDRAM address counter
-		for (uint8_t j = 0; j < 3; j++) {						// Loop to write rows
-			_delay_us(30);
-			for (uint8_t k = 0; k < 16; k++) {					// Loop to write each character in the rows
-				if (!i)
-					lcd_spi_transmit_DATA(i, lcd0_buff[j][k]);
-				else
-					lcd_spi_transmit_DATA(i, lcd1_buff[j][k]);
-				_delay_us(30);
-			}
-		}
+	if (!layout.src) {											// First row ever asked for
+		layout_start(&layout, layout_source, CANVAS_COLS);
+		layout_step = LAYOUT_RING;
+		index_add();											// Checkpoint of row 0
+	}
+	
+	uint16_t i = r / layout_step;								// Last checkpoint at or before r
+	if (i >= layout_marks)
+		i = layout_marks - 1;
+	if (r < layout_first || r + LAYOUT_RING < layout.row || layout_index[i].row > layout.row) {
+		layout_seek(&layout, &layout_index[i]);
+		layout_first = layout.row;
+		layout_text = 0;
+	}
+	
+	while (layout.row <= r) {
+		uint8_t slot = layout.row % LAYOUT_RING;
+		if (layout.row == layout_end) {							// First time the layout gets this far
+			if (layout.row == layout_marks * layout_step)
+				index_add();
+			while (layout_sections < layout.section)			// Sections that start on this row
+				layout_section_row[layout_sections++] = layout.row;
+			layout_end++;
+		}
+		if (layout_next(&layout, layout_ring[slot]))
+			layout_text |= 1 << slot;
+		else
+			layout_text &= ~(1 << slot);
+		loop_stats.rows_laid++;
 	}
+	return layout_ring[r % LAYOUT_RING];
+#else
+	memcpy_P(buf, layout_rows[r], CANVAS_COLS);
+	return buf;
+#endif
+}
 
-}
-
 //***************************************************************************
 //
-// Function Name : int sizeof_array(char* array) & int sizeof_matrix(char** matrix)
-// Date : 4/20/2024
+// Function Name : static uint8_t canvas_more(uint16_t top)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns 1 if the frame with top as its top row can move down by one row,
+// which is while there is text on row top + 2 or below it. The last frame shows the last
+// row with text on it in the middle. With SCROLL_SHOW the answer comes from layout_rows.h,
+// so no row is laid out while the show stream plays.
+//
+// Revision History : Initial version
+//					  1.1 - Taken from layout_rows.h with SCROLL_SHOW
+//
+//**************************************************************************
+
+static uint8_t canvas_more(uint16_t top) {
+#if LAYOUT_STREAM && !SCROLL_SHOW
+	canvas_row(top + 2, NULL);
+	for (uint16_t r = top + 2; r < layout.row; r++)				// Rows already laid out
+		if (layout_text & (1 << (r % LAYOUT_RING)))
+			return 1;
+	return layout_more(&layout);								// Rows not laid out yet
+#else
+	return top + 1 < LAYOUT_ROWS;
+#endif
+}
+
+//***************************************************************************
+//
+// Function Name : static uint16_t canvas_section(uint8_t section)
+// Date : 10/16/2026
 // Version : 1.0
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// These functions help calculate the sizes of each dimension in an array or matrix
+// This function returns the first row of a text or names section, counted from 0 in the
+// order of messages.h, or CANVAS_NONE if there is no such section. With LAYOUT_STREAM a
+// section the layout hasn't reached yet is laid out up to once, and is then known.
 //
-//**************************************************************************
-
-int sizeof_array(char* array) {
-	int size = 0;
-	while (array[size] != '\0') { size++; }
-	return size;
-}
-
-int sizeof_matrix(char** matrix) {
-	int size = 0;
-	while (matrix[size] != NULL) { size++; }
-	return size;
-}
-
+//**************************************************************************
+
+static uint16_t canvas_section(uint8_t section) {
+	if (section >= LAYOUT_SECTIONS)
+		return CANVAS_NONE;
+#if LAYOUT_STREAM
+	canvas_row(0, NULL);
+	while (layout_sections <= section) {						// Lays out on from the furthest row reached
+		if (layout.kind == LAYOUT_END && layout.row == layout_end)
+			return CANVAS_NONE;
+		canvas_row(layout_end, NULL);
+	}
+	return layout_section_row[section];
+#else
+	return pgm_read_word(&layout_section_rows[section]);
+#endif
+}
+
+#if SCROLL_SHOW
 //***************************************************************************
 //
-// Function Name : void insert_split_msg(char* message)
-// Date : 4/20/2024
+// Function Name : static void show_sync(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function brings the shadow copy of every DOG LCD's DDRAM up to date with the frame
+// the show stream left on the DOG LCDs, if it has played since the last time. The 3 rows
+// of the frame are taken from canvas_row, so this is the only time they are laid out.
+//
+//**************************************************************************
+
+static void show_sync(void) {
+	char buf[CANVAS_COLS];
+	
+	if (!show_stale)
+		return;
+	for (uint8_t j = 0; j < 3; j++) {
+		const char* row = canvas_row(show_top + j, buf);
+		for (uint8_t i = 0; i < LCD_PANELS; i++)
+			lcd_shadow_write(i, LCD_ROW_ADDR(j), &row[i * LCD_COLS], LCD_COLS);
+	}
+	show_stale = 0;
+}
+
+//***************************************************************************
+//
+// Function Name : static uint8_t show_play(uint16_t top)
+// Date : 10/16/2026
 // Version : 1.0
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// This function takes a string of any size and separates the message across two
-// LCD buffers. The first (0th) buffer is used for the left LCD (LCD0), and the 
-// second (1st) buffer is used for the right LCD (LCD1). Words that overflow
-// the buffer on the right LCD display are completely moved to the next line of the
-// left LCD for continuity. Spaces at the beginning of the first buffer row are removed
+// This function plays the step of the show stream that moves the frame down to the one
+// with top as its top row, if the DOG LCDs show the frame one row above it. The records of
+// the step are read from flash and queued as they are, so nothing is laid out or compared:
+// SHOW_ALL -> The set DDRAM address command and the characters, broadcast to every DOG LCD
+// SHOW_EACH -> The runs of one row for every DOG LCD, a byte for each DOG LCD in turn as
+//				lcd_update_slices sends them, so each DOG LCD executes a byte while the bus
+//				carries the next byte for another one
+// The bytes queued are the ones display_rows would have queued. The shadow copy of DDRAM
+// is left for show_sync. It returns 0 without sending anything if the step can't be
+// played, and the frame must be rendered instead.
 //
-// Warnings : Make sure that the lcd0_buff and lcd1_buff have enough rows
-//			  to support the length of the message string
+//**************************************************************************
+
+static uint8_t show_play(uint16_t top) {
+	if (!top || top > SHOW_STEPS || show_top != top - 1)
+		return 0;
+	
+	const char* p = &show_stream[pgm_read_word(&show_steps[top - 1])];
+	uint8_t head;
+	
+	if (pgm_read_byte(p) != SHOW_STEP)
+		loop_stats.frames++;
+	while ((head = pgm_read_byte(p++)) != SHOW_STEP) {
+		if ((head & SHOW_KIND) == SHOW_ALL) {
+			uint8_t n = head & SHOW_LEN;
+			lcd_spi_enqueue(LCD_ALL, 0, pgm_read_byte(p++), LCD_GAP_EXEC);	// set DDRAM address
+			while (n--)
+				lcd_spi_enqueue(LCD_ALL, 1, pgm_read_byte(p++), LCD_GAP_EXEC);
+			continue;
+		}
+		
+		const char* at[LCD_PANELS];								// Next byte of each DOG LCD's runs, NULL once they are all queued
+		uint8_t left[LCD_PANELS];								// Characters left in the run being sent, 0 at a run's length byte
+		uint8_t more;
+		
+		for (uint8_t i = 0; i < LCD_PANELS; i++) {				// Finds where each DOG LCD's runs start
+			at[i] = p;
+			left[i] = 0;
+			uint8_t n;
+			while ((n = pgm_read_byte(p++)))
+				p += n + 1;
+		}
+		do {
+			more = 0;
+			for (uint8_t i = 0; i < LCD_PANELS; i++) {
+				if (!at[i])
+					continue;
+				if (left[i]) {
+					left[i]--;
+					lcd_spi_enqueue(i, 1, pgm_read_byte(at[i]++), LCD_GAP_EXEC);	// send character, address counter auto-increments
+				}
+				else if ((left[i] = pgm_read_byte(at[i]++)))
+					lcd_spi_enqueue(i, 0, pgm_read_byte(at[i]++), LCD_GAP_EXEC);	// set DDRAM address
+				else {
+					at[i] = NULL;								// Nothing left for this DOG LCD
+					continue;
+				}
+				more = 1;
+			}
+		} while (more);
+	}
+	show_top = top;
+	show_stale = 1;
+	return 1;
+}
+#endif
+
+//***************************************************************************
+//
+// Function Name : static void display_rows(uint16_t top)
+// Date : 10/16/2026
+// Version : 1.7
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function shows the 3 canvas rows starting at top across the DOG LCDs. Each row is
+// taken from canvas_row and cut into one 16 character slice per DOG LCD, and only the
+// characters that changed since the last frame are queued for transmission. A row that is
+// the same on every DOG LCD is broadcast once by lcd_update_block. The slices of the other
+// rows are queued by lcd_update_slices, a byte for each DOG LCD in turn, so each DOG LCD
+// executes a byte while the bus carries the next byte for another one. The work per frame
+// grows linearly with LCD_PANELS. The rows compared and a frame that queues at least one
+// character are counted in loop_stats. With LAYOUT_STREAM the lookahead rows are laid out after the frame is queued,
+// while it is being sent. With SCROLL_SHOW the shadow is brought up to date with show_sync
+// first, and the frame is noted for show_play.
+//
+// Algorithms : lcd_update_block for the rows that are the same on every DOG LCD,
+//				lcd_update_slices for the others
+//
+// Revision History : Initial version
+//					  1.1 - One canvas row across any number of DOG LCDs
+//					  1.2 - Counts the frames sent
+//					  1.3 - Rows from canvas_row, which can lay them out on demand
+//					  1.4 - Slices sent to the DOG LCDs in turn
+//					  1.5 - Frame noted for the show stream
+//					  1.6 - Header names lcd_update_block and lcd_update_slices
+//					  1.7 - Counts the rows compared
+//
+//**************************************************************************
+
+static void display_rows(uint16_t top) {
+	char buf[CANVAS_COLS];
+	uint8_t sent = 0;
+	
+#if SCROLL_SHOW
+	show_sync();
+	show_top = top;
+#endif
+	
+	for (uint8_t j = 0; j < 3; j++) {							// Loop to update rows, sending only what changed
+		const char* row = canvas_row(top + j, buf);
+		
+		uint8_t same = LCD_COLS;								// Columns that repeat the first slice
+		while (same < CANVAS_COLS && !memcmp(row, &row[same], LCD_COLS))
+			same += LCD_COLS;
+		
+		if (same == CANVAS_COLS)								// Same slice on every DOG LCD, such as a blank line
+			sent |= lcd_update_block(LCD_ALL, LCD_ROW_ADDR(j), row, LCD_COLS);
+		else
+			sent |= lcd_update_slices(LCD_ROW_ADDR(j), row, LCD_COLS);
+		loop_stats.rows_compared++;
+	}
+	
+	if (sent)
+		loop_stats.frames++;
+	
+#if LAYOUT_STREAM
+	canvas_row(top + 2 + LAYOUT_LOOKAHEAD, buf);				// Gets the next rows ready for the next tick
+#endif
+}
+
+#if SCROLL_SMOOTH
+//***************************************************************************
+//
+// Function Name : static void display_slide(uint16_t top, uint8_t line)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function shows the 3 canvas rows starting at top moved up by line pixel lines,
+// with the top of the next row coming in under them, across the DOG LCDs. The 4 rows are
+// taken from canvas_row and drawn with glyph_slide_show, which only sends the glyphs and
+// characters that changed. A frame that queues anything is counted in loop_stats. With
+// LAYOUT_STREAM the lookahead rows are laid out after the frame is queued.
+//
+//**************************************************************************
+
+static void display_slide(uint16_t top, uint8_t line) {
+	char buf[4][CANVAS_COLS];
+	const char* rows[4];
+	
+	for (uint8_t j = 0; j < 4; j++)								// Every row stays in layout_ring until the frame is built
+		rows[j] = canvas_row(top + j, buf[j]);
+	
+	if (glyph_slide_show(rows, line))
+		loop_stats.frames++;
+	
+#if LAYOUT_STREAM
+	canvas_row(top + 3 + LAYOUT_LOOKAHEAD, buf[0]);				// Gets the next rows ready for the next row step
+#endif
+}
+#endif
+
+//***************************************************************************
+//
+// Function Name : static void scroll_tick(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function is called through tick_start from the RTC interrupt and counts the
+// scroll ticks. The rendering is left to scroll_service.
+//
+//**************************************************************************
+
+static void scroll_tick(void) {
+	scroll_ticks++;
+}
+
+//***************************************************************************
+//
+// Function Name : void still_display(void)
+// Date : 3/29/2024
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function updates the text shown on every DOG LCD with the first 3 rows of the canvas,
+// through display_rows. Each row is compared against what the DOG LCDs already show, and only
+// the runs of characters that changed are sent. A row that is the same on every DOG LCD is
+// broadcast once by lcd_update_block, and the slices of a row that differs between them are
+// sent by lcd_update_slices, a byte for each DOG LCD in turn. Repainting an unchanged frame
+// sends nothing. The bytes go out through the transmit queue, so this function returns
+// before the DOG LCDs have been updated.
+//
+// Warnings : layout_rows.h must be generated again whenever messages.h changes
 // Restrictions : none
-// Algorithms : none
+// Algorithms : lcd_update_block for the rows that are the same on every DOG LCD,
+//				lcd_update_slices for the others
 // References : none
 //
 // Revision History : Initial version
+//					  1.1 - Rows that differ between the DOG LCDs sent by lcd_update_slices
 //
-//************************************************************************** 
-
-void insert_split_msg(char* message) {
-	uint8_t LCD_select = 0;
-	int line_size = sizeof_array(message);
-	for (int i = 0, col = 0; i < line_size; i++) {
-		
-		if (!LCD_select && !col && message[i] == ' ') // Skips any blank spaces at the beginning of the first LCD display
-			continue;
-		else if (!LCD_select) // Puts character into left LCD
-			lcd0_buff[lcd0_row][col++] = message[i];
-		else if (LCD_select && col != 0 && !(col % 15) && message[i] != ' ' && message[i] != '\0' && message[i + 1] != ' ' && message[i + 1] != '\0') { // Moves any word that would get cut off on the right LCD to the left LCD
-			lcd1_buff[lcd1_row][16] = '\0';
-			while (lcd1_buff[lcd1_row][col - 1] != ' ' && lcd1_buff[lcd1_row][col - 1] != '\0') { lcd1_buff[lcd1_row][--col] = ' '; i--; }
-			i--;
-			LCD_select = !LCD_select;
-			col = 0;	
-			lcd1_buff[lcd1_row][line_size - 1] = '\0';
-			lcd1_row++;
-			continue;
-		}
-		else // Puts character into right LCD
-			lcd1_buff[lcd1_row][col++] = message[i];
-		
-		if (col != 0 && !(col % 16)) { // Triggers on 16th column index
-			if (!LCD_select)
-				lcd0_buff[lcd0_row++][col] = '\0';
-			else
-				lcd1_buff[lcd1_row++][col] = '\0';
-			LCD_select = !LCD_select;
-			col = 0;
-		}
-	}
-	lcd0_row = ++lcd1_row;
+//**************************************************************************
+
+void still_display(void) {
+	
+	display_rows(0);
+
 }
 
 //***************************************************************************
 //
-// Function Name : void insert_split_names(char** names)
+// Function Name : down_scroll_display(void)
 // Date : 4/20/2024
-// Version : 1.0
+// Version : 1.5
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// This function takes a matrix of stored names to display on both of the LCD
-// displays. The first names are displayed on the left LCD right-justified. The
-// last names are displayed on the right LCD left-justified. Both LCDs must be
-// directly next to each other for the continuity of message.
+// This function starts scrolling the layout rows down across the DOG LCDs and
+// returns right away. The RTC ticks every SCROLLSPEED ms, and each tick moves the frame
+// down by one row until the last row with text on it is in the middle of the DOG LCDs,
+// however many rows the content takes up. The last frame is then held
+// for SCROLLHOLD ms before the scroll stops. scroll_service does the rendering between
+// ticks, so the CPU is free (or asleep) while a scroll is running. Calling this function
+// during a scroll starts it over from the top. Built with SCROLL_SMOOTH, the RTC ticks
+// SCROLL_STEPS times per row instead, and each tick slides the frame up one pixel line.
 //
-// Warnings : Full names can only fill a maximum of 33 characters. The
-//			  first and last name can fill a maximum of 16 characters each.
-//			  Make sure that the lcd0_buff and lcd1_buff have enough rows
-//			  to support the length of the message string
+// Warnings : scroll_service must be called from the main loop for the scroll to advance
 // Restrictions : none
-// Algorithms : sizeof_array
+// Algorithms : display_rows
 // References : none
 //
 // Revision History : Initial version
+//					  1.1 - Timer driven instead of blocking on _delay_ms
+//					  1.2 - Rows read from the flash layout tables
+//					  1.3 - Ticks from the RTC, which keeps time at any CPU clock
+//					  1.4 - Ends on the last row with text instead of a row count, for
+//							rows laid out while scrolling
+//					  1.5 - Smooth scroll
+//
+//**************************************************************************
+
+void down_scroll_display(void) {
+	uint8_t sreg = SREG;
+	cli();
+	
+	scroll_row = 0;
+	scroll_line = 0;
+	scroll_ticks = 0;
+	scroll_state = SCROLL_RUN;
+	display_rows(scroll_row);
+	
+	tick_start(SCROLL_TICKS, scroll_tick);							// Ticks every SCROLLSPEED / SCROLL_STEPS ms from now
+	
+	SREG = sreg;
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t scroll_service(void)
+// Date : 10/16/2026
+// Version : 1.5
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function handles the RTC ticks that arrived since it last ran. The position
+// is advanced by one step for every tick, a row or with SCROLL_SMOOTH a pixel line, so
+// the scroll keeps exact time even if the main loop was late, and only the newest frame
+// is rendered. The frame is queued for transmission and this function returns without
+// waiting for it to be sent. With SCROLL_SHOW, a frame one row on from the one shown is
+// played from the show stream instead of being rendered. It returns 1 while a scroll is
+// running or paused and 0 once it is over.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : display_rows, display_slide, show_play, canvas_more
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Ticks from the RTC instead of TCA0
+//					  1.2 - Asks canvas_more whether there is a row left to move to
+//					  1.3 - Paused scrolls
+//					  1.4 - Steps of a pixel line for the smooth scroll
+//					  1.5 - Row steps played from the show stream
 //
 //**************************************************************************
 
-void insert_split_names(char** names) {
-		
-	uint8_t line_size = 0;
-	for (uint8_t i = 0, tmp_size = 0; i < LINES; i++) {
-		if (names[i] == NULL) break;
-		tmp_size = sizeof_array(names[i]);
-		if (tmp_size > line_size) {
-			line_size = tmp_size;
-		}
-	}
+uint8_t scroll_service(void) {
+	uint8_t sreg = SREG;
+	cli();
+	uint8_t ticks = scroll_ticks;
+	scroll_ticks = 0;
+	SREG = sreg;
 	
-	uint8_t space;
-	for (uint8_t i = 0; i < LINES; i++) {
-		if (names[i] == NULL) break;
-		for (space = 0; space < line_size; space++) // Grabs the index of where the space
-			if (names[i][space] == ' ') 
-				break;
-		
-		for (uint8_t j = 0, k = 0; j < MAX_SIZE; j++) {
-			if (j >= MAX_SIZE - space - 1) {
-				lcd0_buff[lcd0_row][j] = names[i][k++];
-				continue;
-			}
-			lcd0_buff[lcd0_row][j] = ' ';
-		}
-		
-		lcd0_buff[lcd0_row++][MAX_SIZE - 1] = '\0';
-		
-		for (uint8_t j = 0, brk = 1; j < MAX_SIZE; j++) {	
-			if (names[i][space + j + 1] != '\0' && brk)		
-				lcd1_buff[lcd1_row][j] = names[i][space + j + 1];
-			else {
-				brk = 0;
-				lcd1_buff[lcd1_row][j] = ' ';
+	if (!ticks)
+		return scroll_state != SCROLL_IDLE;
+	
+	while (ticks-- && scroll_state != SCROLL_IDLE) {
+		if (scroll_state == SCROLL_RUN) {
+			if (scroll_line || canvas_more(scroll_row)) {
+				if (++scroll_line == SCROLL_STEPS) {				// Moves the frame down by one row
+					scroll_line = 0;
+					scroll_row++;
+				}
+			}
+			else {
+				scroll_state = SCROLL_HOLD;							// Out of rows, holds the last frame
+				scroll_hold = SCROLLHOLD / SCROLLSPEED * SCROLL_STEPS;
 			}
 		}
-	
-		lcd1_buff[lcd1_row++][MAX_SIZE - 1] = '\0';
+		else if (scroll_state == SCROLL_HOLD && !--scroll_hold) {
+			tick_stop();
+			scroll_state = SCROLL_IDLE;
+			still_dirty = 1;										// Back to the still display
+		}
 	}
+	
+	if (scroll_state == SCROLL_RUN)
+#if SCROLL_SMOOTH
+		display_slide(scroll_row, scroll_line);
+#elif SCROLL_SHOW
+		if (!show_play(scroll_row))								// Rendered if the frame shown isn't the row above
+			display_rows(scroll_row);
+#else
+		display_rows(scroll_row);
+#endif
+	
+	return scroll_state != SCROLL_IDLE;
 }
 
 //***************************************************************************
 //
-// Function Name : void insert_newline(void)
-// Date : 5/11/2024
+// Function Name : uint8_t scroll_pending(void)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns 1 if an RTC tick is waiting to be handled by scroll_service
+// or marquee_service. The main loop checks it with interrupts disabled right before
+// going to sleep.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Marquee ticks
+//
+//**************************************************************************
+
+uint8_t scroll_pending(void) {
+	return scroll_ticks != 0 || marquee_ticks != 0;
+}
+
+//***************************************************************************
+//
+// Function Name : void scroll_stop(void)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function ends a running scroll right away and stops its ticks, skipping whatever
+// rows and hold time were left. The main loop then shows the still display again.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Ticks from the RTC instead of TCA0
+//
+//**************************************************************************
+
+void scroll_stop(void) {
+	uint8_t sreg = SREG;
+	cli();
+	tick_stop();
+	scroll_ticks = 0;
+	scroll_state = SCROLL_IDLE;
+	still_dirty = 1;
+	SREG = sreg;
+}
+
+//***************************************************************************
+//
+// Function Name : static void scroll_show(uint16_t top)
+// Date : 10/16/2026
 // Version : 1.0
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// This function adds a new line onto both lcd_buffs
+// This function stops the ticks of a running scroll and shows the frame with top as its
+// top row until the scroll is told to move again.
 //
-// Warnings : 
+//**************************************************************************
+
+static void scroll_show(uint16_t top) {
+	marquee_stop();
+	
+	uint8_t sreg = SREG;
+	cli();
+	tick_stop();
+	scroll_ticks = 0;
+	scroll_state = SCROLL_PAUSE;
+	scroll_row = top;
+	scroll_line = 0;
+	SREG = sreg;
+	
+	display_rows(top);
+}
+
+//***************************************************************************
+//
+// Function Name : void scroll_up(void) & void scroll_down(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// These functions move the frame up or down by one row and pause the scroll there, so
+// the frame stays until the scroll is moved again, resumed or stopped. They do nothing
+// past the first row or the last frame. From the still display they start at row 0.
+// A running marquee is stopped.
+//
+// Warnings : Must be called from the main loop, not from an ISR
 // Restrictions : none
-// Algorithms : sizeof_array
+// Algorithms : canvas_more, display_rows
 // References : none
 //
 // Revision History : Initial version
 //
-//**************************************************************************
-
-void insert_newline(void) {
-	strcpy(lcd0_buff[lcd0_row++], "                ");
-	strcpy(lcd1_buff[lcd1_row++], "                ");
-}
-
+//**************************************************************************
+
+void scroll_up(void) {
+	uint16_t top = scroll_state == SCROLL_IDLE ? 0 : scroll_row;
+	scroll_show(top ? top - 1 : 0);
+}
+
+void scroll_down(void) {
+	uint16_t top = scroll_state == SCROLL_IDLE ? 0 : scroll_row;
+	scroll_show(canvas_more(top) ? top + 1 : top);
+}
+
 //***************************************************************************
 //
-// Function Name : center_justify()
-// Date : 5/10/2024
+// Function Name : uint8_t scroll_jump(uint8_t section)
+// Date : 10/16/2026
 // Version : 1.0
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// This function takes two matrices and centers the strings across each of the rows
+// This function pauses the scroll on the frame that starts with the first row of a
+// section, counted from 0 in the order of messages.h (LAYOUT_SECTION_MESSAGE,
+// LAYOUT_SECTION_NAMES and LAYOUT_SECTION_THANKS in layout_rows.h). A section too close
+// to the end is shown on the last frame instead. It returns 0 if there is no such
+// section. The first row of each section is looked up in the row table, or with
+// LAYOUT_STREAM found the first time the layout gets to it and then kept.
 //
-// Warnings : Full names can only fill a maximum of 33 characters. The
-//			  first and last name can fill a maximum of 16 characters each.
-//			  Make sure that the lcd0_buff and lcd1_buff have enough rows
-//			  to support the length of the message string
+// Warnings : Must be called from the main loop, not from an ISR
 // Restrictions : none
-// Algorithms : sizeof_array
+// Algorithms : canvas_section, canvas_more, display_rows
 // References : none
 //
 // Revision History : Initial version
 //
-//**************************************************************************
-
-void center_justify(void) {
-	uint8_t count;
-	
-	for (uint8_t i = 0; i < LINES; i++) {
-		if (lcd0_buff[i][0] == ' ' || !strlen(lcd0_buff[i])) // Skips if it's not a left-justified message or an empty message
-			continue;
-			
-		count = 0;
-		for (uint8_t j = MAX_SIZE - 2; j > 0; j--) { // Starts at index that can have last possible character and counts whitespaces/nulls
-			if (lcd1_buff[i][j] != ' ' && lcd1_buff[i][j] != '\0')
-				break;
-			lcd1_buff[i][j] = ' ';							// Replaces any other null characters with spaces
-			count++;
-		}
-		
-		for (uint8_t j = 0; j < (count)/2; j++) {
-			for (uint8_t k = MAX_SIZE - 2; k > 0; k--) {	// Shifts all contents of matrix1 to the right by 1
-				lcd1_buff[i][k] = lcd1_buff[i][k - 1];
-			}
-			
-			lcd1_buff[i][0] = lcd0_buff[i][MAX_SIZE - 2];				// First index of matrix1 gets the rolled over value of matrix0
-			
-			for (uint8_t k = MAX_SIZE - 2; k > 0; k--) {	// Shifts all contents of matrix0 to the right by 1
-				lcd0_buff[i][k] = lcd0_buff[i][k - 1];
-			}
-			lcd0_buff[i][0] = ' ';
-		}
-	}
-	
-}
-
+//**************************************************************************
+
+uint8_t scroll_jump(uint8_t section) {
+	uint16_t top = canvas_section(section);
+	if (top == CANVAS_NONE)
+		return 0;
+	
+	while (top && !canvas_more(top - 1))						// Past the last frame
+		top--;
+	scroll_show(top);
+	return 1;
+}
+
 //***************************************************************************
 //
-// Function Name : down_scroll_display(void)
-// Date : 4/20/2024
+// Function Name : void scroll_resume(void)
+// Date : 10/16/2026
 // Version : 1.0
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// This function takes a matrix of stored names to display on both of the LCD
-// displays. The first names are displayed on the left LCD right-justified. The
-// last names are displayed on the right LCD left-justified. Both LCDs must be
-// directly next to each other for the continuity of message.
+// This function carries on scrolling down from the frame a paused scroll shows, one row
+// every SCROLLSPEED ms as down_scroll_display does. If the scroll isn't paused it starts
+// one from the top.
 //
-// Warnings : Full names can only fill a maximum of 33 characters. The
-//			  first and last name can fill a maximum of 16 characters each.
-//			  Make sure that the lcd0_buff and lcd1_buff have enough rows
-//			  to support the length of the message string
+// Warnings : scroll_service must be called from the main loop for the scroll to advance
 // Restrictions : none
-// Algorithms : sizeof_array
+// Algorithms : down_scroll_display
 // References : none
 //
 // Revision History : Initial version
 //
-//**************************************************************************
-
-void down_scroll_display(void) {
-	
-	for (uint8_t i = 0; i < LINES; i++) {							// Loop for number of down scrolls
-		if (lcd0_buff[i][0] == '\0' || lcd1_buff[i][0] == '\0') break;
-		for (uint8_t j = 0; j < 2; j++) {							// Loop to write left/right LCD display
-			init_spi_lcd();
-			lcd_spi_transmit_CMD(j, 0x80);							// init DDRAM address counter
-			for (uint8_t k = 0; k < 3; k++) {						// Loop to write rows
-				_delay_us(30);
-				for (uint8_t l = 0; l < 16; l++) {					// Loop to write each character in the rows
-					if (!j)
-						lcd_spi_transmit_DATA(j, lcd0_buff[i + k][l]);
-					else
-						lcd_spi_transmit_DATA(j, lcd1_buff[i + k][l]);
-					_delay_us(30);
-				}
-			}
-		}
-		_delay_ms(SCROLLSPEED);
-	}
-	_delay_ms(1000);
-}
-
+//**************************************************************************
+
+void scroll_resume(void) {
+	if (scroll_state != SCROLL_PAUSE) {
+		down_scroll_display();
+		return;
+	}
+	
+	uint8_t sreg = SREG;
+	cli();
+	scroll_ticks = 0;
+	scroll_state = SCROLL_RUN;
+	tick_start(SCROLL_TICKS, scroll_tick);						// Next step SCROLLSPEED / SCROLL_STEPS ms from now
+	SREG = sreg;
+}
+
 //***************************************************************************
 //
-// Function Name : repeat(void* func(void), int n)
-// Date : 5/11/2024
+// Function Name : static void marquee_tick(void)
+// Date : 10/16/2026
 // Version : 1.0
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// This function repeats the specified function for n amount of times
+// This function is called through tick_start from the RTC interrupt and counts the
+// marquee ticks. The display shift commands are left to marquee_service.
+//
+//**************************************************************************
+
+static void marquee_tick(void) {
+	marquee_ticks++;
+}
+
+//***************************************************************************
+//
+// Function Name : void marquee_start(void)
+// Date : 10/16/2026
+// Version : 1.2
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function starts the big font "THANK YOU!" marquee, which runs right to left
+// across the DOG LCDs, from the last one into LCD0. The steps are shown below:
+// 1) Switches every DOG LCD to the double height font, which clears its line to spaces
+// 2) Broadcasts MARQUEE_TEXT once into the off-screen part of the 80 character line,
+//	  just past the right edge of the last DOG LCD
+// 3) Shifts DOG LCD n left by 16 * n columns on its own, so the DOG LCDs show
+//	  neighbouring 16 column windows of the same line
+// 4) Starts the RTC ticks, one every MARQUEE_SPEED ms
+// From then on marquee_service moves the text one column per tick with a single display
+// shift command broadcast to every DOG LCD, and DDRAM is never written again. The line
+// wraps around, so the text comes back in from the right once it has left LCD0.
+// Built with MARQUEE_GLYPHS, the text is drawn 3 rows tall by glyph_show in the 3 line
+// font instead, starting just off the right edge of the last DOG LCD. With SCROLL_SHOW,
+// the shadow copy of DDRAM is first brought up to date with what the show stream left.
+//
+// Warnings : Stops a running scroll
+// Restrictions : none
+// Algorithms : lcd_font_mode, lcd_spi_write_block, glyph_show, show_sync
+// References : ST7036 datasheet, cursor or display shift
+//
+// Revision History : Initial version
+//					  1.1 - CGRAM glyphs with MARQUEE_GLYPHS
+//					  1.2 - Shadow brought up to date after the show stream
+//
+//**************************************************************************
+
+void marquee_start(void) {
+	scroll_stop();
+	
+#if SCROLL_SHOW
+	show_sync();
+	show_top = CANVAS_NONE;
+#endif
+	
+#if MARQUEE_GLYPHS
+	marquee_x = CANVAS_COLS;
+	glyph_show(MARQUEE_TEXT, marquee_x, 3);							// Blank canvas, the text is just off the right edge
+#else
+	lcd_font_mode(1);												// Double height, every line cleared to spaces
+	lcd_spi_write_block(LCD_ALL, MARQUEE_COL, MARQUEE_TEXT, sizeof(MARQUEE_TEXT) - 1);
+	for (uint8_t i = 1; i < LCD_PANELS; i++)						// DOG LCD i shows the 16 columns to the right of DOG LCD i - 1
+		for (uint8_t j = 0; j < i * LCD_COLS % LCD_LINE_SIZE; j++)
+			lcd_spi_enqueue(i, 0, LCD_SHIFT_LEFT, LCD_GAP_EXEC);
+#endif
+	
+	uint8_t sreg = SREG;
+	cli();
+	marquee_ticks = 0;
+	marquee_on = 1;
+	tick_start(MARQUEE_TICKS, marquee_tick);						// Ticks every MARQUEE_SPEED ms from now
+	SREG = sreg;
+	
+	still_dirty = 0;
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t marquee_service(void) & void marquee_stop(void)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// marquee_service sends one display shift command to every DOG LCD at once for each
+// RTC tick since it last ran, so each step of the marquee costs one byte on the bus
+// however many DOG LCDs there are. It returns 1 while the marquee is running.
+// marquee_stop ends the marquee, puts the DOG LCDs back in the 3 line font and leaves
+// the still display to be drawn again.
+// Built with MARQUEE_GLYPHS, marquee_service moves the big characters one column left
+// and draws the frame once for all the ticks, which sends the cells that changed and
+// the few glyphs that aren't in CGRAM yet. The text comes back in from the right once
+// it has left LCD0. marquee_stop leaves the 3 line font as it is.
+//
+// Warnings : Must be called from the main loop, not from an ISR
+// Restrictions : none
+// Algorithms : lcd_spi_enqueue, lcd_font_mode, glyph_show
+// References : ST7036 datasheet, cursor or display shift
+//
+// Revision History : Initial version
+//					  1.1 - CGRAM glyphs with MARQUEE_GLYPHS
+//
+//**************************************************************************
+
+uint8_t marquee_service(void) {
+	uint8_t sreg = SREG;
+	cli();
+	uint8_t ticks = marquee_ticks;
+	marquee_ticks = 0;
+	SREG = sreg;
+	
+	if (!marquee_on)
+		return 0;
+	
+	if (ticks)
+		loop_stats.frames++;
+#if MARQUEE_GLYPHS
+	if (ticks) {
+		while (ticks--)
+			if (--marquee_x < MARQUEE_END)
+				marquee_x = CANVAS_COLS;
+		glyph_show(MARQUEE_TEXT, marquee_x, 3);
+	}
+#else
+	while (ticks--)
+		lcd_spi_enqueue(LCD_ALL, 0, LCD_SHIFT_LEFT, LCD_GAP_EXEC);	// Every DOG LCD moves one column together
+#endif
+	
+	return 1;
+}
+
+void marquee_stop(void) {
+	if (!marquee_on)
+		return;
+	
+	tick_stop();
+	marquee_ticks = 0;
+	marquee_on = 0;
+#if !MARQUEE_GLYPHS
+	lcd_font_mode(0);												// Back to 3 lines, cleared to spaces
+#endif
+	still_dirty = 1;
+}
+
+//***************************************************************************
+//
+// Function Name : void display_clock(uint8_t mhz)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function sets the CPU clock the display work runs at. The steps are shown below:
+// 1) Returns right away if the CPU already runs at mhz
+// 2) Waits for the transmit queue to drain, since the gap in flight is counted in CPU clocks
+// 3) Sets the new clock with sysclk_set
+// 4) Works out the SPI timing profile for the new clock with lcd_spi_clock
+// The main loop raises the clock to SYSCLK_FAST_MHZ when there is a frame to build and
+// drops it to SYSCLK_IDLE_MHZ once the frame has been sent.
+//
+// Warnings : Must be called from the main loop, not from an ISR
+// Restrictions : mhz must be a setting sysclk_set accepts
+// Algorithms : lcd_spi_flush, sysclk_set, lcd_spi_clock
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void display_clock(uint8_t mhz) {
+	if (mhz == sysclk_mhz())
+		return;
+	
+	lcd_spi_flush();
+	sysclk_set(mhz);
+	lcd_spi_clock();
+}
+
+//***************************************************************************
+//
+// Function Name : static void press_shown(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function is called through lcd_spi_notify once the first frame of a press has
+// been shifted out, and records how long it took since the PB2 edge.
+//
+//**************************************************************************
+
+static void press_shown(void) {
+	uint32_t us = CLOCK_US(clock_ticks() - press_time);
+	press_latency.last_us = us;
+	if (us > press_latency.max_us)
+		press_latency.max_us = us;
+}
+
+//***************************************************************************
+//
+// Function Name : void dispatch_events(void)
+// Date : 10/16/2026
+// Version : 1.2
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function handles the events posted by the interrupts since it last ran. The
+// actions for each event are shown below:
+// EVENT_PRESS -> Pauses a running scroll on the frame shown, carries on from there if
+//				  the scroll is paused, or else starts the scroll from the top
+// EVENT_HOLD -> Starts the big font marquee if the long press began on the still display,
+//				 otherwise skips the rest of the scroll or ends the marquee and goes back
+//				 to the still display
+// The time from the PB2 edge of a press until its first frame has been shifted out is
+// recorded in press_latency. A press that comes in during a scroll is handled on the
+// next pass of the main loop, which is always within one frame.
+//
+// Warnings : Must be called from the main loop, not from an ISR
+// Restrictions : none
+// Algorithms : down_scroll_display, scroll_show, scroll_resume, scroll_stop,
+//				marquee_start, marquee_stop
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Long press toggles the marquee
+//					  1.2 - A press pauses and resumes a running scroll
+//
+//**************************************************************************
+
+void dispatch_events(void) {
+	event_t event;
+	
+	while (event_get(&event)) {
+		switch (event.type) {
+			case EVENT_PRESS:
+				press_from_still = scroll_state == SCROLL_IDLE && !marquee_on;
+				if (scroll_state == SCROLL_RUN)
+					scroll_show(scroll_row);						// Pauses on the frame shown
+				else if (scroll_state == SCROLL_PAUSE)
+					scroll_resume();
+				else {
+					marquee_stop();
+					down_scroll_display();							// Queues the first frame of the scroll
+				}
+				press_time = event.time;
+				press_latency.presses++;
+				lcd_spi_notify(press_shown);						// Times the frame once it is on the DOG LCDs
+				break;
+			case EVENT_HOLD:
+				if (press_from_still)								// The scroll the press started gives way to the marquee
+					marquee_start();
+				else												// Back to the still display
+					scroll_stop();
+				break;
+		}
+	}
+}
+
+//***************************************************************************
+//
+// Function Name : void display_service(void)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function renders a frame only when there is a new one to show. A running marquee
+// or scroll is left to marquee_service or scroll_service. Otherwise the still display is
+// drawn once after reset and once after each scroll or marquee ends or is stopped, and is
+// not touched again until then.
+//
+// Warnings : Must be called from the main loop, not from an ISR
+// Restrictions : none
+// Algorithms : marquee_service, scroll_service, still_display
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Marquee
+//
+//**************************************************************************
+
+void display_service(void) {
+	if (marquee_service() || scroll_service())
+		return;
+	
+	if (still_dirty) {
+		still_dirty = 0;
+		still_display();
+	}
+}
+
+//***************************************************************************
+//
+// Function Name : void idle_sleep(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function puts the AVR128DB48 to sleep until an interrupt brings in more work.
+// The steps are shown below:
+// 1) Drops the CPU clock to SYSCLK_IDLE_MHZ once the transmit queue has drained
+// 2) Checks for a pending event or scroll tick with interrupts disabled, and returns
+//	  right away if there is one, so work that came in late never waits for a wake up
+// 3) Sleeps in idle while bytes are still queued, since SPI0 and TCB0 must keep
+//	  running, or in standby once the queue is empty, where only the RTC and the PB2
+//	  edge can wake the CPU
+// 4) Counts the wake up and the RTC ticks spent asleep in loop_stats
+//
+// Warnings : Must be called from the main loop, not from an ISR
+// Restrictions : none
+// Algorithms : display_clock
+// References : AVR128DB48 datasheet, sleep modes
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void idle_sleep(void) {
+	if (lcd_spi_idle())
+		display_clock(SYSCLK_IDLE_MHZ);						// Frame is on the DOG LCDs, drops the clock until the next one
+	
+	cli();
+	if (!scroll_pending() && !event_pending()) {			// Work that came in since the checks above must not wait for the next wake up
+		set_sleep_mode(lcd_spi_idle() ? SLEEP_MODE_STANDBY : SLEEP_MODE_IDLE);
+		uint32_t start = clock_ticks();
+		sleep_enable();
+		sei();												// Interrupts can only wake the CPU once it sleeps, so none are missed
+		sleep_cpu();										// Sleeps until a TCB0 gap, SPI transfer, PB2 edge or RTC tick or overflow
+		sleep_disable();
+		cli();
+		loop_stats.asleep_ticks += clock_ticks() - start;
+		loop_stats.wakeups++;
+	}
+	sei();
+}
+
+//***************************************************************************
+//
+// Function Name : uint32_t loop_duty_ppm(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns the share of the time since init_events that the CPU spent
+// awake, in parts per million, from the RTC ticks counted in loop_stats.
 //
 // Warnings : none
 // Restrictions : none
-// Algorithms : sizeof_array
+// Algorithms : none
 // References : none
 //
 // Revision History : Initial version
 //
-//**************************************************************************
-
-void repeat(void func(void), int n) {
-	for (uint8_t i = 0; i < n; i++) func();
-}
\ No newline at end of file
+//**************************************************************************
+
+uint32_t loop_duty_ppm(void) {
+	uint32_t now = clock_ticks();
+	if (!now)
+		return 0;
+	return (uint32_t)((uint64_t)(now - loop_stats.asleep_ticks) * 1000000UL / now);
+}
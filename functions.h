@@ -9,7 +9,13 @@
 // Author : Dylan Wong & Baron Mai
 //
 // This header file declares all the higher level functions to display the proper
-// messages on the LCD screens
+// messages on the LCD screens. The rows shown are laid out from the source stream in
+// layout_rows.h by the layout engine in layout.c as the scroll reaches them, so only a
+// few rows are ever in RAM. Built with LAYOUT_STREAM=0, they are read from the flash row
+// table in layout_rows.h instead. Built with SCROLL_SMOOTH=1, the down scroll slides the
+// text up one pixel line at a time with glyph_slide_show. Built with SCROLL_SHOW=1, each
+// row step of the down scroll is played from the show stream in layout_rows.h, the bytes
+// layout_gen worked out for it, so the frame is neither laid out nor compared.
 //
 // Warnings :
 // Restrictions : none
@@ -24,214 +30,481 @@
 #ifndef FUNCTIONS_H_
 #define FUNCTIONS_H_
 
-#define F_CPU 4000000LU
-#define LINES 100
-#define MAX_SIZE 17
 #define SCROLLSPEED 500
+#define SCROLLHOLD 1000
+#ifndef SCROLL_SMOOTH
+#define SCROLL_SMOOTH 0											// 1 slides the scroll up one pixel line per tick with CGRAM glyphs, 0 moves it a row per tick
+#endif
+#ifndef SCROLL_SHOW
+#define SCROLL_SHOW 0											// 1 plays the row steps of the down scroll from the show stream, 0 renders each frame
+#endif
+#define MARQUEE_SPEED 200										// ms per column of the big font marquee
+#define MARQUEE_TEXT "THANK YOU!"
+#ifndef MARQUEE_GLYPHS
+#define MARQUEE_GLYPHS 0										// 1 draws the marquee 3 rows tall with CGRAM glyphs, 0 in the double height font
+#endif
+
+#ifndef LAYOUT_STREAM
+#define LAYOUT_STREAM 1											// 1 lays the rows out while scrolling, 0 reads them from the flash row table
+#endif
+#define LAYOUT_LOOKAHEAD 1										// Rows laid out ahead of the frame shown
+#define LAYOUT_INDEX_SIZE 32									// Checkpoints kept for going back to earlier rows
 
 #include <avr/io.h>
 #include <stdlib.h>
-#include <util/delay.h>
+#include "sysclk.h"
 #include <string.h>
 
-char lcd0_buff[LINES][MAX_SIZE];
-char lcd1_buff[LINES][MAX_SIZE];
+// Pushbutton response times, from the PB2 edge to the new frame being shifted out to the DOG LCDs
+typedef struct {
+	uint16_t presses;									// Presses that reached the dispatcher
+	uint32_t last_us;
+	uint32_t max_us;
+} press_latency_t;
+
+extern volatile press_latency_t press_latency;
+
+// Main loop activity, to check that the cost of an unchanged display is close to zero
+typedef struct {
+	uint32_t wakeups;									// Times the CPU woke up from sleep
+	uint32_t frames;									// Frames that queued at least one character
+	uint32_t asleep_ticks;								// RTC ticks spent asleep
+	uint32_t rows_laid;									// Canvas rows laid out by layout_next
+	uint32_t rows_compared;								// Canvas rows display_rows compared against the shadow
+} loop_stats_t;
 
-int lcd0_row, lcd1_row;
+extern loop_stats_t loop_stats;
 
 //***************************************************************************
 //
-// Function Name : int sizeof_array(char* array) & int sizeof_matrix(char** matrix)
-// Date : 4/20/2024
-// Version : 1.0
+// Function Name : void still_display(void)
+// Date : 3/29/2024
+// Version : 1.1
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// These functions help calculate the sizes of each dimension in an array or matrix
+// This function updates the text shown on every DOG LCD with the first 3 rows of the canvas,
+// through display_rows. Each row is compared against what the DOG LCDs already show, and only
+// the runs of characters that changed are sent. A row that is the same on every DOG LCD is
+// broadcast once by lcd_update_block, and the slices of a row that differs between them are
+// sent by lcd_update_slices, a byte for each DOG LCD in turn. Repainting an unchanged frame
+// sends nothing. The bytes go out through the transmit queue, so this function returns
+// before the DOG LCDs have been updated.
+//
+// Warnings : layout_rows.h must be generated again whenever messages.h changes
+// Restrictions : none
+// Algorithms : lcd_update_block for the rows that are the same on every DOG LCD,
+//				lcd_update_slices for the others
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Rows that differ between the DOG LCDs sent by lcd_update_slices
 //
 //**************************************************************************
-
-int sizeof_array(char* array);
 
-int sizeof_matrix(char** matrix);
+void still_display(void);
 
 //***************************************************************************
 //
-// Function Name : void still_display(void)
-// Date : 3/29/2024
-// Version : 1.0
+// Function Name : down_scroll_display(void)
+// Date : 4/20/2024
+// Version : 1.5
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// This function updates the text shown on both the DOG LCDs. This function uses both of the
-// SPI transmit functions written above to send the proper information. First, an address
-// is sent to let the DOG LCD know which line it's writing in. Then, a for-loop is used to transmit
-// all of the bytes in the display buffers. This step is repeated for all of the 3 lines and buffers.
+// This function starts scrolling the layout rows down across the DOG LCDs and
+// returns right away. The RTC ticks every SCROLLSPEED ms, and each tick moves the frame
+// down by one row until the last row with text on it is in the middle of the DOG LCDs,
+// however many rows the content takes up. The last frame is then held
+// for SCROLLHOLD ms before the scroll stops. scroll_service does the rendering between
+// ticks, so the CPU is free (or asleep) while a scroll is running. Calling this function
+// during a scroll starts it over from the top. Built with SCROLL_SMOOTH, the RTC ticks
+// SCROLL_STEPS times per row instead, and each tick slides the frame up one pixel line.
 //
-// Warnings : Ensure that the 3 line buffers are populated with 17 total characters
+// Warnings : scroll_service must be called from the main loop for the scroll to advance
 // Restrictions : none
-// Algorithms : init_spi_lcd, lcd_spi_transmit_CMD, lcd_spi_transmit_DATA
+// Algorithms : display_rows
 // References : none
 //
 // Revision History : Initial version
+//					  1.1 - Timer driven instead of blocking on _delay_ms
+//					  1.2 - Rows read from the flash layout tables
+//					  1.3 - Ticks from the RTC, which keeps time at any CPU clock
+//					  1.4 - Ends on the last row with text instead of a row count, for
+//							rows laid out while scrolling
+//					  1.5 - Smooth scroll
 //
-//**************************************************************************
+//**************************************************************************
 
-void still_display(void);
+void down_scroll_display(void);
 
 //***************************************************************************
 //
-// Function Name : void insert_split_msg(char* message)
-// Date : 4/20/2024
-// Version : 1.0
+// Function Name : uint8_t scroll_service(void)
+// Date : 10/16/2026
+// Version : 1.5
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// This function takes a string of any size and separates the message across two
-// LCD buffers. The first (0th) buffer is used for the left LCD (LCD0), and the
-// second (1st) buffer is used for the right LCD (LCD1). Words that overflow
-// the buffer on the right LCD display are completely moved to the next line of the
-// left LCD for continuity. Spaces at the beginning of the first buffer row are removed
+// This function handles the RTC ticks that arrived since it last ran. The position
+// is advanced by one step for every tick, a row or with SCROLL_SMOOTH a pixel line, so
+// the scroll keeps exact time even if the main loop was late, and only the newest frame
+// is rendered. The frame is queued for transmission and this function returns without
+// waiting for it to be sent. With SCROLL_SHOW, a frame one row on from the one shown is
+// played from the show stream instead of being rendered. It returns 1 while a scroll is
+// running or paused and 0 once it is over.
 //
-// Warnings : Make sure that the lcd0_buff and lcd1_buff have enough rows
-//			  to support the length of the message string
+// Warnings : none
 // Restrictions : none
-// Algorithms : none
+// Algorithms : display_rows, display_slide, show_play, canvas_more
 // References : none
 //
 // Revision History : Initial version
+//					  1.1 - Ticks from the RTC instead of TCA0
+//					  1.2 - Asks canvas_more whether there is a row left to move to
+//					  1.3 - Paused scrolls
+//					  1.4 - Steps of a pixel line for the smooth scroll
+//					  1.5 - Row steps played from the show stream
 //
 //**************************************************************************
 
-void insert_split_msg(char* message);
+uint8_t scroll_service(void);
 
 //***************************************************************************
 //
-// Function Name : void insert_split_names(char** names)
-// Date : 4/20/2024
+// Function Name : uint8_t scroll_pending(void)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns 1 if an RTC tick is waiting to be handled by scroll_service
+// or marquee_service. The main loop checks it with interrupts disabled right before
+// going to sleep.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Marquee ticks
+//
+//**************************************************************************
+
+uint8_t scroll_pending(void);
+
+//***************************************************************************
+//
+// Function Name : void scroll_stop(void)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function ends a running scroll right away and stops its ticks, skipping whatever
+// rows and hold time were left. The main loop then shows the still display again.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Ticks from the RTC instead of TCA0
+//
+//**************************************************************************
+
+void scroll_stop(void);
+
+//***************************************************************************
+//
+// Function Name : void scroll_up(void) & void scroll_down(void)
+// Date : 10/16/2026
 // Version : 1.0
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// This function takes a matrix of stored names to display on both of the LCD
-// displays. The first names are displayed on the left LCD right-justified. The
-// last names are displayed on the right LCD left-justified. Both LCDs must be
-// directly next to each other for the continuity of message.
+// These functions move the frame up or down by one row and pause the scroll there, so
+// the frame stays until the scroll is moved again, resumed or stopped. They do nothing
+// past the first row or the last frame. From the still display they start at row 0.
+// A running marquee is stopped.
 //
-// Warnings : Full names can only fill a maximum of 33 characters. The
-//			  first and last name can fill a maximum of 16 characters each.
-//			  Make sure that the lcd0_buff and lcd1_buff have enough rows
-//			  to support the length of the message string
+// Warnings : Must be called from the main loop, not from an ISR
 // Restrictions : none
-// Algorithms : sizeof_array
+// Algorithms : canvas_more, display_rows
 // References : none
 //
 // Revision History : Initial version
 //
-//**************************************************************************
-
-void insert_split_names(char** names);
+//**************************************************************************
+
+void scroll_up(void);
+
+void scroll_down(void);
 
 //***************************************************************************
 //
-// Function Name : void insert_newline(void)
-// Date : 5/11/2024
+// Function Name : uint8_t scroll_jump(uint8_t section)
+// Date : 10/16/2026
 // Version : 1.0
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// This function adds a new line onto both lcd_buffs
+// This function pauses the scroll on the frame that starts with the first row of a
+// section, counted from 0 in the order of messages.h (LAYOUT_SECTION_MESSAGE,
+// LAYOUT_SECTION_NAMES and LAYOUT_SECTION_THANKS in layout_rows.h). A section too close
+// to the end is shown on the last frame instead. It returns 0 if there is no such
+// section. The first row of each section is looked up in the row table, or with
+// LAYOUT_STREAM found the first time the layout gets to it and then kept.
 //
-// Warnings :
+// Warnings : Must be called from the main loop, not from an ISR
 // Restrictions : none
-// Algorithms : sizeof_array
+// Algorithms : canvas_section, canvas_more, display_rows
 // References : none
 //
 // Revision History : Initial version
 //
-//**************************************************************************
-
-void insert_newline(void);
+//**************************************************************************
+
+uint8_t scroll_jump(uint8_t section);
 
 //***************************************************************************
 //
-// Function Name : center_justify()
-// Date : 5/10/2024
+// Function Name : void scroll_resume(void)
+// Date : 10/16/2026
 // Version : 1.0
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// This function takes two matrices and centers the strings across each of the rows
+// This function carries on scrolling down from the frame a paused scroll shows, one row
+// every SCROLLSPEED ms as down_scroll_display does. If the scroll isn't paused it starts
+// one from the top.
 //
-// Warnings : Full names can only fill a maximum of 33 characters. The
-//			  first and last name can fill a maximum of 16 characters each.
-//			  Make sure that the lcd0_buff and lcd1_buff have enough rows
-//			  to support the length of the message string
+// Warnings : scroll_service must be called from the main loop for the scroll to advance
 // Restrictions : none
-// Algorithms : sizeof_array
+// Algorithms : down_scroll_display
 // References : none
 //
 // Revision History : Initial version
 //
-//**************************************************************************
-
-void center_justify();
+//**************************************************************************
+
+void scroll_resume(void);
 
 //***************************************************************************
 //
-// Function Name : down_scroll_display(void)
-// Date : 4/20/2024
+// Function Name : void marquee_start(void)
+// Date : 10/16/2026
+// Version : 1.2
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function starts the big font "THANK YOU!" marquee, which runs right to left
+// across the DOG LCDs, from the last one into LCD0. The steps are shown below:
+// 1) Switches every DOG LCD to the double height font, which clears its line to spaces
+// 2) Broadcasts MARQUEE_TEXT once into the off-screen part of the 80 character line,
+//	  just past the right edge of the last DOG LCD
+// 3) Shifts DOG LCD n left by 16 * n columns on its own, so the DOG LCDs show
+//	  neighbouring 16 column windows of the same line
+// 4) Starts the RTC ticks, one every MARQUEE_SPEED ms
+// From then on marquee_service moves the text one column per tick with a single display
+// shift command broadcast to every DOG LCD, and DDRAM is never written again. The line
+// wraps around, so the text comes back in from the right once it has left LCD0.
+// Built with MARQUEE_GLYPHS, the text is drawn 3 rows tall by glyph_show in the 3 line
+// font instead, starting just off the right edge of the last DOG LCD. With SCROLL_SHOW,
+// the shadow copy of DDRAM is first brought up to date with what the show stream left.
+//
+// Warnings : Stops a running scroll
+// Restrictions : none
+// Algorithms : lcd_font_mode, lcd_spi_write_block, glyph_show, show_sync
+// References : ST7036 datasheet, cursor or display shift
+//
+// Revision History : Initial version
+//					  1.1 - CGRAM glyphs with MARQUEE_GLYPHS
+//					  1.2 - Shadow brought up to date after the show stream
+//
+//**************************************************************************
+
+void marquee_start(void);
+
+//***************************************************************************
+//
+// Function Name : uint8_t marquee_service(void) & void marquee_stop(void)
+// Date : 10/16/2026
 // Version : 1.0
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// This function takes a matrix of stored names to display on both of the LCD
-// displays. The first names are displayed on the left LCD right-justified. The
-// last names are displayed on the right LCD left-justified. Both LCDs must be
-// directly next to each other for the continuity of message.
+// marquee_service sends one display shift command to every DOG LCD at once for each
+// RTC tick since it last ran, so each step of the marquee costs one byte on the bus
+// however many DOG LCDs there are. It returns 1 while the marquee is running.
+// marquee_stop ends the marquee, puts the DOG LCDs back in the 3 line font and leaves
+// the still display to be drawn again.
 //
-// Warnings : Full names can only fill a maximum of 33 characters. The
-//			  first and last name can fill a maximum of 16 characters each.
-//			  Make sure that the lcd0_buff and lcd1_buff have enough rows
-//			  to support the length of the message string
+// Warnings : Must be called from the main loop, not from an ISR
 // Restrictions : none
-// Algorithms : sizeof_array
+// Algorithms : lcd_spi_enqueue, lcd_font_mode
+// References : ST7036 datasheet, cursor or display shift
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint8_t marquee_service(void);
+
+void marquee_stop(void);
+
+//***************************************************************************
+//
+// Function Name : void display_clock(uint8_t mhz)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function sets the CPU clock the display work runs at. The steps are shown below:
+// 1) Returns right away if the CPU already runs at mhz
+// 2) Waits for the transmit queue to drain, since the gap in flight is counted in CPU clocks
+// 3) Sets the new clock with sysclk_set
+// 4) Works out the SPI timing profile for the new clock with lcd_spi_clock
+// The main loop raises the clock to SYSCLK_FAST_MHZ when there is a frame to build and
+// drops it to SYSCLK_IDLE_MHZ once the frame has been sent.
+//
+// Warnings : Must be called from the main loop, not from an ISR
+// Restrictions : mhz must be a setting sysclk_set accepts
+// Algorithms : lcd_spi_flush, sysclk_set, lcd_spi_clock
 // References : none
 //
 // Revision History : Initial version
 //
-//**************************************************************************
-
-void down_scroll_display(void);
+//**************************************************************************
+
+void display_clock(uint8_t mhz);
 
 //***************************************************************************
 //
-// Function Name : repeat(void* func(void), int n)
-// Date : 5/11/2024
+// Function Name : void dispatch_events(void)
+// Date : 10/16/2026
+// Version : 1.2
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function handles the events posted by the interrupts since it last ran. The
+// actions for each event are shown below:
+// EVENT_PRESS -> Pauses a running scroll on the frame shown, carries on from there if
+//				  the scroll is paused, or else starts the scroll from the top
+// EVENT_HOLD -> Starts the big font marquee if the long press began on the still display,
+//				 otherwise skips the rest of the scroll or ends the marquee and goes back
+//				 to the still display
+// The time from the PB2 edge of a press until its first frame has been shifted out is
+// recorded in press_latency. A press that comes in during a scroll is handled on the
+// next pass of the main loop, which is always within one frame.
+//
+// Warnings : Must be called from the main loop, not from an ISR
+// Restrictions : none
+// Algorithms : down_scroll_display, scroll_show, scroll_resume, scroll_stop,
+//				marquee_start, marquee_stop
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Long press toggles the marquee
+//					  1.2 - A press pauses and resumes a running scroll
+//
+//**************************************************************************
+
+void dispatch_events(void);
+
+//***************************************************************************
+//
+// Function Name : void display_service(void)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function renders a frame only when there is a new one to show. A running marquee
+// or scroll is left to marquee_service or scroll_service. Otherwise the still display is
+// drawn once after reset and once after each scroll or marquee ends or is stopped, and is
+// not touched again until then.
+//
+// Warnings : Must be called from the main loop, not from an ISR
+// Restrictions : none
+// Algorithms : marquee_service, scroll_service, still_display
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Marquee
+//
+//**************************************************************************
+
+void display_service(void);
+
+//***************************************************************************
+//
+// Function Name : void idle_sleep(void)
+// Date : 10/16/2026
 // Version : 1.0
 // Target MCU : AVR128DB48
 // Target Hardware : AVR128DB48
 // Author : Dylan Wong
 //
-// This function repeats the specified function for n amount of times
+// This function puts the AVR128DB48 to sleep until an interrupt brings in more work.
+// The steps are shown below:
+// 1) Drops the CPU clock to SYSCLK_IDLE_MHZ once the transmit queue has drained
+// 2) Checks for a pending event or scroll tick with interrupts disabled, and returns
+//	  right away if there is one, so work that came in late never waits for a wake up
+// 3) Sleeps in idle while bytes are still queued, since SPI0 and TCB0 must keep
+//	  running, or in standby once the queue is empty, where only the RTC and the PB2
+//	  edge can wake the CPU
+// 4) Counts the wake up and the RTC ticks spent asleep in loop_stats
+//
+// Warnings : Must be called from the main loop, not from an ISR
+// Restrictions : none
+// Algorithms : display_clock
+// References : AVR128DB48 datasheet, sleep modes
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void idle_sleep(void);
+
+//***************************************************************************
+//
+// Function Name : uint32_t loop_duty_ppm(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns the share of the time since init_events that the CPU spent
+// awake, in parts per million, from the RTC ticks counted in loop_stats.
 //
 // Warnings : none
 // Restrictions : none
-// Algorithms : sizeof_array
+// Algorithms : none
 // References : none
 //
 // Revision History : Initial version
 //
-//**************************************************************************
-
-void repeat(void func(void), int n);
+//**************************************************************************
+
+uint32_t loop_duty_ppm(void);
 
 
 #endif /* FUNCTIONS_H_ */
\ No newline at end of file
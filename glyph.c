@@ -0,0 +1,720 @@
+//***************************************************************************
+//
+// File Name : glyph.c
+// Title :
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This file defines the CGRAM glyph engine, its slot cache, the big characters built
+// from quarter block glyphs and the sliding text of the smooth scroll.
+//
+// Warnings :
+// Restrictions : none
+// Algorithms : none
+// References : ST7036 datasheet, character ROM
+//
+// Revision History : Initial version
+//					  1.1 - Sliding text
+//
+//
+//**************************************************************************
+
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#include "glyph.h"
+#include "DOGM163WA.h"
+
+#define GLYPH_FULL 0xFF									// Full block of the character ROM
+#define GLYPH_LEFT 0x1C									// Pixels of the left half of a cell row, the middle column is in both halves
+#define GLYPH_RIGHT 0x07
+#define GLYPH_MISS 0x10									// Cell whose glyph isn't loaded yet, ORed with its quarters
+#define GLYPH_FIRST ' '									// First character with a picture in glyph_font
+#define GLYPH_LAST 'Z'
+#define GLYPH_ROM_FIRST ' '								// First character with a picture in glyph_rom
+#define GLYPH_ROM_LAST '~'
+#define GLYPH_ROM_ROWS 7								// Pixel rows of a ROM character, above the cursor row
+#define GLYPH_PAIR(a, b) ((uint16_t)(uint8_t)(a) << 8 | (uint8_t)(b))	// Key of a sliding cell, never a quarter key since a is printable
+
+// Quarters of a cell, as the bits of its key
+#define GLYPH_TL 0x01
+#define GLYPH_TR 0x02
+#define GLYPH_BL 0x04
+#define GLYPH_BR 0x08
+
+static uint16_t glyph_key[GLYPH_SLOTS];					// Glyph in each slot, GLYPH_EMPTY if none is known
+static uint16_t glyph_time[GLYPH_SLOTS];				// Frame that last used each slot
+static uint8_t glyph_refs[GLYPH_SLOTS];					// Cells of the frame being built that use each slot
+static uint8_t glyph_shown;								// Bit n is set if the last frame showed slot n
+static uint16_t glyph_clock;							// Time stamp of the frame being built
+static uint8_t glyph_pixels[GLYPH_SLOTS][GLYPH_ROWS];	// Pixel rows last written to each slot
+
+// 6 by 6 block pictures of the big characters, the top row first and bit 5 on the left
+static const uint8_t glyph_font[GLYPH_LAST - GLYPH_FIRST + 1][6] PROGMEM = {
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// ' '
+	{ 0x0C, 0x0C, 0x0C, 0x0C, 0x00, 0x0C },				// '!'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// '"'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// '#'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// '$'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// '%'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// '&'
+	{ 0x0C, 0x0C, 0x00, 0x00, 0x00, 0x00 },				// "'"
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// '('
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// ')'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// '*'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// '+'
+	{ 0x00, 0x00, 0x00, 0x00, 0x0C, 0x18 },				// ','
+	{ 0x00, 0x00, 0x3F, 0x00, 0x00, 0x00 },				// '-'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C },				// '.'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// '/'
+	{ 0x3F, 0x33, 0x33, 0x33, 0x33, 0x3F },				// '0'
+	{ 0x0C, 0x3C, 0x0C, 0x0C, 0x0C, 0x3F },				// '1'
+	{ 0x3F, 0x03, 0x3F, 0x30, 0x30, 0x3F },				// '2'
+	{ 0x3F, 0x03, 0x1F, 0x03, 0x03, 0x3F },				// '3'
+	{ 0x33, 0x33, 0x3F, 0x03, 0x03, 0x03 },				// '4'
+	{ 0x3F, 0x30, 0x3F, 0x03, 0x03, 0x3F },				// '5'
+	{ 0x3F, 0x30, 0x3F, 0x33, 0x33, 0x3F },				// '6'
+	{ 0x3F, 0x03, 0x06, 0x0C, 0x0C, 0x0C },				// '7'
+	{ 0x3F, 0x33, 0x3F, 0x33, 0x33, 0x3F },				// '8'
+	{ 0x3F, 0x33, 0x3F, 0x03, 0x03, 0x3F },				// '9'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// ':'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// ';'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// '<'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// '='
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// '>'
+	{ 0x3F, 0x03, 0x0F, 0x0C, 0x00, 0x0C },				// '?'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },				// '@'
+	{ 0x1E, 0x33, 0x3F, 0x33, 0x33, 0x33 },				// 'A'
+	{ 0x3E, 0x33, 0x3E, 0x33, 0x33, 0x3E },				// 'B'
+	{ 0x1F, 0x30, 0x30, 0x30, 0x30, 0x1F },				// 'C'
+	{ 0x3E, 0x33, 0x33, 0x33, 0x33, 0x3E },				// 'D'
+	{ 0x3F, 0x30, 0x3C, 0x30, 0x30, 0x3F },				// 'E'
+	{ 0x3F, 0x30, 0x3C, 0x30, 0x30, 0x30 },				// 'F'
+	{ 0x1F, 0x30, 0x37, 0x33, 0x33, 0x1E },				// 'G'
+	{ 0x33, 0x33, 0x3F, 0x33, 0x33, 0x33 },				// 'H'
+	{ 0x3F, 0x0C, 0x0C, 0x0C, 0x0C, 0x3F },				// 'I'
+	{ 0x03, 0x03, 0x03, 0x03, 0x33, 0x1E },				// 'J'
+	{ 0x33, 0x36, 0x3C, 0x36, 0x33, 0x33 },				// 'K'
+	{ 0x30, 0x30, 0x30, 0x30, 0x30, 0x3F },				// 'L'
+	{ 0x33, 0x3F, 0x3F, 0x33, 0x33, 0x33 },				// 'M'
+	{ 0x33, 0x3B, 0x3F, 0x37, 0x33, 0x33 },				// 'N'
+	{ 0x1E, 0x33, 0x33, 0x33, 0x33, 0x1E },				// 'O'
+	{ 0x3E, 0x33, 0x3E, 0x30, 0x30, 0x30 },				// 'P'
+	{ 0x1E, 0x33, 0x33, 0x33, 0x36, 0x1B },				// 'Q'
+	{ 0x3E, 0x33, 0x3E, 0x36, 0x33, 0x33 },				// 'R'
+	{ 0x1F, 0x30, 0x1E, 0x03, 0x03, 0x3E },				// 'S'
+	{ 0x3F, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C },				// 'T'
+	{ 0x33, 0x33, 0x33, 0x33, 0x33, 0x1E },				// 'U'
+	{ 0x33, 0x33, 0x33, 0x33, 0x1E, 0x0C },				// 'V'
+	{ 0x33, 0x33, 0x33, 0x3F, 0x3F, 0x33 },				// 'W'
+	{ 0x33, 0x1E, 0x0C, 0x0C, 0x1E, 0x33 },				// 'X'
+	{ 0x33, 0x33, 0x1E, 0x0C, 0x0C, 0x0C },				// 'Y'
+	{ 0x3F, 0x03, 0x06, 0x0C, 0x18, 0x3F },				// 'Z'
+};
+
+static const uint8_t glyph_rows2[4] PROGMEM = { 0, 2, 3, 5 };	// Picture rows of a character 2 rows tall
+
+// 5 by 7 pictures of the printable ASCII characters of the character ROM, the top row
+// first and the 5 low bits of each row left to right
+static const uint8_t glyph_rom[GLYPH_ROM_LAST - GLYPH_ROM_FIRST + 1][GLYPH_ROM_ROWS] PROGMEM = {
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },			// ' '
+	{ 0x04, 0x04, 0x04, 0x04, 0x00, 0x00, 0x04 },			// '!'
+	{ 0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00 },			// '"'
+	{ 0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A },			// '#'
+	{ 0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04 },			// '$'
+	{ 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 },			// '%'
+	{ 0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D },			// '&'
+	{ 0x0C, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00 },			// "'"
+	{ 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 },			// '('
+	{ 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 },			// ')'
+	{ 0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00 },			// '*'
+	{ 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 },			// '+'
+	{ 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 },			// ','
+	{ 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 },			// '-'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C },			// '.'
+	{ 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 },			// '/'
+	{ 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E },			// '0'
+	{ 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E },			// '1'
+	{ 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F },			// '2'
+	{ 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E },			// '3'
+	{ 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 },			// '4'
+	{ 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E },			// '5'
+	{ 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E },			// '6'
+	{ 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },			// '7'
+	{ 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E },			// '8'
+	{ 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C },			// '9'
+	{ 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 },			// ':'
+	{ 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08 },			// ';'
+	{ 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02 },			// '<'
+	{ 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 },			// '='
+	{ 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08 },			// '>'
+	{ 0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 },			// '?'
+	{ 0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E },			// '@'
+	{ 0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11 },			// 'A'
+	{ 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E },			// 'B'
+	{ 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E },			// 'C'
+	{ 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C },			// 'D'
+	{ 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F },			// 'E'
+	{ 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 },			// 'F'
+	{ 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F },			// 'G'
+	{ 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 },			// 'H'
+	{ 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E },			// 'I'
+	{ 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C },			// 'J'
+	{ 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 },			// 'K'
+	{ 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F },			// 'L'
+	{ 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 },			// 'M'
+	{ 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 },			// 'N'
+	{ 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },			// 'O'
+	{ 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 },			// 'P'
+	{ 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D },			// 'Q'
+	{ 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 },			// 'R'
+	{ 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E },			// 'S'
+	{ 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },			// 'T'
+	{ 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },			// 'U'
+	{ 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 },			// 'V'
+	{ 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A },			// 'W'
+	{ 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 },			// 'X'
+	{ 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 },			// 'Y'
+	{ 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F },			// 'Z'
+	{ 0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E },			// '['
+	{ 0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00 },			// '\\'
+	{ 0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E },			// ']'
+	{ 0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00 },			// '^'
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F },			// '_'
+	{ 0x08, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00 },			// '`'
+	{ 0x00, 0x00, 0x0E, 0x01, 0x0F, 0x11, 0x0F },			// 'a'
+	{ 0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1E },			// 'b'
+	{ 0x00, 0x00, 0x0E, 0x10, 0x10, 0x11, 0x0E },			// 'c'
+	{ 0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x0F },			// 'd'
+	{ 0x00, 0x00, 0x0E, 0x11, 0x1F, 0x10, 0x0E },			// 'e'
+	{ 0x06, 0x09, 0x08, 0x1C, 0x08, 0x08, 0x08 },			// 'f'
+	{ 0x00, 0x0F, 0x11, 0x11, 0x0F, 0x01, 0x0E },			// 'g'
+	{ 0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11 },			// 'h'
+	{ 0x04, 0x00, 0x0C, 0x04, 0x04, 0x04, 0x0E },			// 'i'
+	{ 0x02, 0x00, 0x06, 0x02, 0x02, 0x12, 0x0C },			// 'j'
+	{ 0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12 },			// 'k'
+	{ 0x0C, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E },			// 'l'
+	{ 0x00, 0x00, 0x1A, 0x15, 0x15, 0x11, 0x11 },			// 'm'
+	{ 0x00, 0x00, 0x16, 0x19, 0x11, 0x11, 0x11 },			// 'n'
+	{ 0x00, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E },			// 'o'
+	{ 0x00, 0x00, 0x1E, 0x11, 0x1E, 0x10, 0x10 },			// 'p'
+	{ 0x00, 0x00, 0x0D, 0x13, 0x0F, 0x01, 0x01 },			// 'q'
+	{ 0x00, 0x00, 0x16, 0x19, 0x10, 0x10, 0x10 },			// 'r'
+	{ 0x00, 0x00, 0x0E, 0x10, 0x0E, 0x01, 0x1E },			// 's'
+	{ 0x08, 0x08, 0x1C, 0x08, 0x08, 0x09, 0x06 },			// 't'
+	{ 0x00, 0x00, 0x11, 0x11, 0x11, 0x13, 0x0D },			// 'u'
+	{ 0x00, 0x00, 0x11, 0x11, 0x11, 0x0A, 0x04 },			// 'v'
+	{ 0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0A },			// 'w'
+	{ 0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11 },			// 'x'
+	{ 0x00, 0x00, 0x11, 0x11, 0x0F, 0x01, 0x0E },			// 'y'
+	{ 0x00, 0x00, 0x1F, 0x02, 0x04, 0x08, 0x1F },			// 'z'
+	{ 0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02 },			// '{'
+	{ 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },			// '|'
+	{ 0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08 },			// '}'
+	{ 0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00 },			// '~'
+};
+
+//***************************************************************************
+//
+// Function Name : void glyph_begin(void) & void glyph_end(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// glyph_begin starts a frame: the reference count of every slot goes back to 0, and the
+// frame gets the next time stamp. glyph_end ends it, and remembers which slots the frame
+// shows, so the next frame leaves them alone for as long as it can.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void glyph_begin(void) {
+	memset(glyph_refs, 0, sizeof(glyph_refs));
+	glyph_clock++;
+}
+
+void glyph_end(void) {
+	glyph_shown = 0;
+	for (uint8_t s = 0; s < GLYPH_SLOTS; s++)
+		if (glyph_refs[s])
+			glyph_shown |= 1 << s;
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t glyph_use(uint16_t key)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns the slot that holds the glyph key, counts one more cell of the
+// frame that uses it and marks it as used by the frame. It returns GLYPH_NONE if the
+// glyph isn't in CGRAM.
+//
+// Warnings : none
+// Restrictions : key must not be GLYPH_EMPTY
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint8_t glyph_use(uint16_t key) {
+	for (uint8_t s = 0; s < GLYPH_SLOTS; s++)
+		if (glyph_key[s] == key) {
+			glyph_refs[s]++;
+			glyph_time[s] = glyph_clock;
+			return s;
+		}
+	return GLYPH_NONE;
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t glyph_load(uint16_t key, const uint8_t* rows)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function uploads the 8 pixel rows of the glyph key into a slot, counts the cell
+// that uses it and returns the slot. Only the rows that differ from the glyph the slot
+// held are sent. The slot is picked as shown below:
+// 1) Slots used by a cell of this frame are never taken
+// 2) An empty slot is taken first
+// 3) Then the least recently used slot that the last frame didn't show, so no cell on
+//	  the glass changes before its new character is written
+// 4) Then the least recently used of the rest
+// It returns GLYPH_NONE if every slot is used by this frame.
+//
+// Warnings : Call glyph_use for every cell of the frame first, so a glyph the frame
+//			  needs isn't replaced
+// Restrictions : The 5 low bits of each row are the pixels, left to right
+// Algorithms : glyph_write
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Sends only the rows that changed
+//
+//**************************************************************************
+
+uint8_t glyph_load(uint16_t key, const uint8_t* rows) {
+	uint8_t slot = GLYPH_NONE;
+	uint8_t best_rank = 0;
+	uint16_t best_age = 0;
+
+	for (uint8_t s = 0; s < GLYPH_SLOTS; s++) {
+		if (glyph_refs[s])										// Needed by this frame
+			continue;
+		uint8_t rank = glyph_key[s] == GLYPH_EMPTY ? 2 : !(glyph_shown & (1 << s));	// Empty, then not on the glass
+		uint16_t age = glyph_clock - glyph_time[s];				// Frames since it was last used
+		if (slot == GLYPH_NONE || rank > best_rank || (rank == best_rank && age > best_age)) {
+			slot = s;
+			best_rank = rank;
+			best_age = age;
+		}
+	}
+	if (slot == GLYPH_NONE)
+		return GLYPH_NONE;
+
+	if (glyph_key[slot] == GLYPH_EMPTY)							// Whatever is in CGRAM is unknown
+		memset(glyph_pixels[slot], 0xFF, GLYPH_ROWS);
+	glyph_write(slot, rows);
+	glyph_key[slot] = key;
+	glyph_time[slot] = glyph_clock;
+	glyph_refs[slot] = 1;
+	return slot;
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t glyph_write(uint8_t slot, const uint8_t* rows)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function redraws the glyph in slot with new pixel rows, keeping its key, for a
+// glyph that changes from one frame to the next. Only the run of rows from the first to
+// the last one that changed is sent, with one lcd_cgram_write. It returns 1 if anything
+// was sent.
+//
+// Warnings : Every cell that shows the slot changes with it
+// Restrictions : The 5 low bits of each row are the pixels, left to right
+// Algorithms : lcd_cgram_write
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint8_t glyph_write(uint8_t slot, const uint8_t* rows) {
+	uint8_t* pixels = glyph_pixels[slot];
+	uint8_t first = 0;
+	uint8_t last = GLYPH_ROWS;
+
+	while (first < GLYPH_ROWS && pixels[first] == rows[first])
+		first++;
+	if (first == GLYPH_ROWS)									// Nothing changed
+		return 0;
+	while (pixels[last - 1] == rows[last - 1])
+		last--;
+
+	lcd_cgram_write(LCD_ALL, slot, first, &rows[first], last - first);
+	memcpy(&pixels[first], &rows[first], last - first);
+	return 1;
+}
+
+//***************************************************************************
+//
+// Function Name : void glyph_reset(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function forgets what is in CGRAM, so every glyph is uploaded again when it is
+// next used. The ST7036 doesn't clear CGRAM at power up, so the slots start out empty
+// as far as the engine knows.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void glyph_reset(void) {
+	memset(glyph_key, 0, sizeof(glyph_key));					// GLYPH_EMPTY
+	glyph_shown = 0;
+}
+
+//***************************************************************************
+//
+// Function Name : static uint8_t glyph_quarters(const char* text, uint8_t len, int16_t x, uint8_t height, uint8_t row, uint8_t col)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns which quarters of cell row, col are filled, with the first big
+// character of text, len characters long, at column x.
+//
+//**************************************************************************
+
+static uint8_t glyph_quarters(const char* text, uint8_t len, int16_t x, uint8_t height, uint8_t row, uint8_t col) {
+	int16_t at = col - x;
+	if (at < 0 || at % GLYPH_PITCH == GLYPH_WIDTH)				// Left of the text, or the blank column between characters
+		return 0;
+
+	uint8_t n = at / GLYPH_PITCH;
+	if (n >= len)												// Right of the text
+		return 0;
+
+	char c = text[n];
+	if (c >= 'a' && c <= 'z')
+		c -= 'a' - 'A';
+	if (c < GLYPH_FIRST || c > GLYPH_LAST)
+		return 0;
+
+	uint8_t shift = 2 * (GLYPH_WIDTH - 1 - at % GLYPH_PITCH);	// Bits of the cell in the picture rows
+	uint8_t top = 2 * row, bottom = 2 * row + 1;
+	if (height == 2) {
+		top = pgm_read_byte(&glyph_rows2[top]);
+		bottom = pgm_read_byte(&glyph_rows2[bottom]);
+	}
+	uint8_t t = pgm_read_byte(&glyph_font[c - GLYPH_FIRST][top]) >> shift;
+	uint8_t b = pgm_read_byte(&glyph_font[c - GLYPH_FIRST][bottom]) >> shift;
+
+	return (t & 2 ? GLYPH_TL : 0) | (t & 1 ? GLYPH_TR : 0) | (b & 2 ? GLYPH_BL : 0) | (b & 1 ? GLYPH_BR : 0);
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t glyph_text(const char* text, int16_t x, uint8_t height, char* cells, uint8_t cols)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function draws text in big characters into cells, height rows of cols DDRAM
+// characters, as one glyph frame. The first character starts at column x, which can be
+// off the left edge, and whatever falls off either edge is cut. The steps are shown below:
+// 1) Works out the quarters of every cell from the 6 by 6 picture of its character.
+//	  Characters 2 rows tall use the picture's rows 0, 2, 3 and 5
+// 2) Uses the space and the full block for empty and full cells, and glyph_use for the
+//	  rest, keeping the cells whose glyph isn't in CGRAM yet
+// 3) Loads those glyphs with glyph_load. A cell that still has no slot, because the
+//	  frame needs more than 8 glyphs, gets the full block if at least 2 of its quarters
+//	  are filled and a space otherwise
+// Lower case letters are drawn as upper case, and characters with no picture as spaces.
+// It returns the number of glyphs uploaded.
+//
+// Warnings : none
+// Restrictions : height must be 2 or 3
+// Algorithms : glyph_begin, glyph_use, glyph_load, glyph_end
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint8_t glyph_text(const char* text, int16_t x, uint8_t height, char* cells, uint8_t cols) {
+	uint8_t loaded = 0;
+	uint8_t len = strlen(text);
+	uint16_t n = height * cols;
+
+	glyph_begin();
+
+	for (uint16_t i = 0; i < n; i++) {							// Glyphs already in CGRAM
+		uint8_t q = glyph_quarters(text, len, x, height, i / cols, i % cols);
+		uint8_t slot;
+		if (q == 0)
+			cells[i] = ' ';
+		else if (q == (GLYPH_TL | GLYPH_TR | GLYPH_BL | GLYPH_BR))
+			cells[i] = GLYPH_FULL;
+		else if ((slot = glyph_use(q)) != GLYPH_NONE)
+			cells[i] = slot;
+		else
+			cells[i] = GLYPH_MISS | q;
+	}
+
+	for (uint16_t i = 0; i < n; i++) {							// Glyphs to upload
+		if ((uint8_t)cells[i] < GLYPH_MISS || (uint8_t)cells[i] > (GLYPH_MISS | 0x0F))
+			continue;
+
+		uint8_t q = cells[i] & 0x0F;
+		uint8_t slot = glyph_use(q);							// Loaded for an earlier cell of this frame
+		if (slot == GLYPH_NONE) {
+			uint8_t rows[GLYPH_ROWS];
+			for (uint8_t r = 0; r < GLYPH_ROWS; r++) {
+				uint8_t half = r < GLYPH_ROWS / 2 ? q : q >> 2;	// Top quarters on the upper 4 pixel rows
+				rows[r] = (half & GLYPH_TL ? GLYPH_LEFT : 0) | (half & GLYPH_TR ? GLYPH_RIGHT : 0);
+			}
+			slot = glyph_load(q, rows);
+			if (slot != GLYPH_NONE)
+				loaded++;
+		}
+		if (slot != GLYPH_NONE)
+			cells[i] = slot;
+		else															// More than 8 glyphs in the frame
+			cells[i] = (q & (q - 1)) ? GLYPH_FULL : ' ';
+	}
+
+	glyph_end();
+	return loaded;
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t glyph_show(const char* text, int16_t x, uint8_t height)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function shows text in big characters across the canvas of DOG LCDs, from the top
+// row down, with glyph_text. Each row is brought up to date on every DOG LCD with
+// lcd_update_slices, so only the cells that changed are sent, taking turns between the
+// DOG LCDs. It returns the number of glyphs uploaded.
+//
+// Warnings : The DOG LCDs must be in the 3 line font
+// Restrictions : height must be 2 or 3
+// Algorithms : glyph_text, lcd_update_slices
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Rows sent to the DOG LCDs in turn
+//
+//**************************************************************************
+
+uint8_t glyph_show(const char* text, int16_t x, uint8_t height) {
+	char cells[3][LCD_PANELS * LCD_COLS];
+	uint8_t loaded = glyph_text(text, x, height, cells[0], LCD_PANELS * LCD_COLS);
+
+	for (uint8_t r = 0; r < height; r++)
+		lcd_update_slices(LCD_ROW_ADDR(r), cells[r], LCD_COLS);
+	return loaded;
+}
+
+//***************************************************************************
+//
+// Function Name : static uint8_t glyph_pair(char a, char b, uint8_t line, uint8_t* pixels)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function writes the 8 pixel rows of a cell that shows character a moved up by line
+// pixel lines, with the top of character b coming in under it, into pixels. It returns 0
+// if the cell is blank.
+//
+//**************************************************************************
+
+static uint8_t glyph_pair(char a, char b, uint8_t line, uint8_t* pixels) {
+	uint8_t any = 0;
+
+	for (uint8_t r = 0; r < GLYPH_ROWS; r++) {
+		uint8_t y = r + line;									// Row of a, or of b once past the bottom of a
+		char c = a;
+		if (y >= GLYPH_ROWS) {
+			c = b;
+			y -= GLYPH_ROWS;
+		}
+		pixels[r] = y < GLYPH_ROM_ROWS && c >= GLYPH_ROM_FIRST && c <= GLYPH_ROM_LAST ?
+			pgm_read_byte(&glyph_rom[c - GLYPH_ROM_FIRST][y]) : 0;
+		any |= pixels[r];
+	}
+	return any;
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t glyph_slide(const char* const* rows, uint8_t line, char* cells, uint8_t cols)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function draws 3 rows of text moved up by line pixel lines into cells, 3 rows of
+// cols DDRAM characters, as one glyph frame. rows points to 4 rows of text, cols characters
+// each, and every cell shows the bottom of its character in one row over the top of the
+// character under it in the next. The steps are shown below:
+// 1) Uses the character itself when line is 0, and a space for a cell that comes out
+//	  blank, such as one between 2 spaces
+// 2) Uses glyph_use for the rest, with the pair of characters as the key, so a pair keeps
+//	  its slot for as long as it is on the glass
+// 3) Redraws every slot the frame uses at line pixel lines with glyph_write, and loads the
+//	  pairs that aren't in CGRAM yet with glyph_load. A cell that still has no slot, because
+//	  the frame has more than 8 pairs, shows the upper character until the text has moved
+//	  half a row, and the lower one after that
+// It returns the number of glyphs uploaded or redrawn.
+//
+// Warnings : none
+// Restrictions : line must be under GLYPH_ROWS
+// Algorithms : glyph_begin, glyph_use, glyph_write, glyph_load, glyph_end
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint8_t glyph_slide(const char* const* rows, uint8_t line, char* cells, uint8_t cols) {
+	uint8_t written = 0;
+	uint8_t fresh = 0;											// Bit n is set once slot n is drawn at line
+	uint8_t pixels[GLYPH_ROWS];
+	uint16_t n = 3 * cols;
+
+	glyph_begin();
+
+	for (uint16_t i = 0; i < n; i++) {							// Pairs already in CGRAM
+		char a = rows[i / cols][i % cols];
+		char b = rows[i / cols + 1][i % cols];
+		uint8_t slot;
+		if (!line)
+			cells[i] = a;
+		else if (!glyph_pair(a, b, line, pixels))
+			cells[i] = ' ';
+		else if ((slot = glyph_use(GLYPH_PAIR(a, b))) != GLYPH_NONE)
+			cells[i] = slot;
+		else
+			cells[i] = GLYPH_MISS;
+	}
+
+	for (uint16_t i = 0; i < n && line; i++) {					// Slots to redraw and pairs to upload
+		uint8_t slot = cells[i];
+		if (slot == GLYPH_MISS)
+			slot = glyph_use(GLYPH_PAIR(rows[i / cols][i % cols], rows[i / cols + 1][i % cols]));	// Loaded for an earlier cell of this frame
+		else if (slot >= GLYPH_SLOTS)							// A character of the ROM
+			continue;
+		if (slot != GLYPH_NONE && (fresh & (1 << slot))) {
+			cells[i] = slot;
+			continue;
+		}
+
+		char a = rows[i / cols][i % cols];
+		char b = rows[i / cols + 1][i % cols];
+		glyph_pair(a, b, line, pixels);
+		if (slot != GLYPH_NONE)
+			written += glyph_write(slot, pixels);
+		else if ((slot = glyph_load(GLYPH_PAIR(a, b), pixels)) != GLYPH_NONE)
+			written++;
+
+		if (slot != GLYPH_NONE) {
+			cells[i] = slot;
+			fresh |= 1 << slot;
+		}
+		else															// More than 8 pairs in the frame
+			cells[i] = line < GLYPH_ROWS / 2 ? a : b;
+	}
+
+	glyph_end();
+	return written;
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t glyph_slide_show(const char* const* rows, uint8_t line)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function shows 4 canvas rows moved up by line pixel lines across the DOG LCDs,
+// with glyph_slide. Each row is brought up to date on every DOG LCD with
+// lcd_update_slices, taking turns between them, and a row that is the same on every DOG
+// LCD is broadcast once with lcd_update_block. It returns 1 if anything was queued for
+// transmission.
+//
+// Warnings : The DOG LCDs must be in the 3 line font
+// Restrictions : line must be under GLYPH_ROWS, and the rows must be
+//				  LCD_PANELS * LCD_COLS characters
+// Algorithms : glyph_slide, lcd_update_block, lcd_update_slices
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Rows sent to the DOG LCDs in turn
+//
+//**************************************************************************
+
+uint8_t glyph_slide_show(const char* const* rows, uint8_t line) {
+	char cells[3][LCD_PANELS * LCD_COLS];
+	uint8_t sent = glyph_slide(rows, line, cells[0], LCD_PANELS * LCD_COLS) != 0;
+
+	for (uint8_t r = 0; r < 3; r++) {
+		uint8_t same = LCD_COLS;								// Columns that repeat the first slice
+		while (same < LCD_PANELS * LCD_COLS && !memcmp(cells[r], &cells[r][same], LCD_COLS))
+			same += LCD_COLS;
+
+		if (same == LCD_PANELS * LCD_COLS)						// Same slice on every DOG LCD, such as a blank line
+			sent |= lcd_update_block(LCD_ALL, LCD_ROW_ADDR(r), cells[r], LCD_COLS);
+		else
+			sent |= lcd_update_slices(LCD_ROW_ADDR(r), cells[r], LCD_COLS) != 0;
+	}
+	return sent;
+}
@@ -0,0 +1,311 @@
+//***************************************************************************
+//
+// File Name : glyph.h
+// Title :
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This header file declares the CGRAM glyph engine. The ST7036 has 8 CGRAM slots for
+// characters of its own, so the engine keeps track of which glyph is in each slot and
+// only uploads the ones a frame needs that aren't there yet. A frame is built with the
+// steps shown below:
+// 1) glyph_begin starts the frame
+// 2) glyph_use is called for every cell that shows a glyph, and returns its slot if the
+//	  glyph is already in CGRAM
+// 3) glyph_load is called for each glyph glyph_use didn't find, and uploads it into the
+//	  least recently used slot that no cell of the frame needs
+// 4) glyph_end ends the frame
+// Glyphs are told apart by a key that the caller picks. Every DOG LCD holds the same
+// glyphs, since they are uploaded to all of them at once.
+//
+// The big characters drawn by glyph_text are 3 cells wide and 2 or 3 rows tall. Each
+// cell is split into 4 quarters, so a character is a 6 by 6 block picture, and every
+// cell shows one of the 16 ways to fill its quarters. The empty and full cells are the
+// space and the full block of the character ROM, and the other 14 are CGRAM glyphs.
+//
+// glyph_slide draws rows of text moved up by a few pixel lines, for a smooth scroll. A
+// cell that shows the bottom of one character over the top of the one below it is a
+// glyph keyed by the pair of characters, drawn from a copy of the character ROM's
+// pictures, and it is redrawn in the same slot as the text moves on. The engine keeps
+// the pixel rows of every slot, so only the rows that changed are sent.
+//
+// Warnings : Nothing else may write CGRAM while the engine is used
+// Restrictions : none
+// Algorithms : Least recently used replacement with reference counts
+// References : ST7036 datasheet, set CGRAM address
+//
+// Revision History : Initial version
+//					  1.1 - Sliding text for the smooth scroll
+//
+//
+//**************************************************************************
+
+#ifndef GLYPH_H_
+#define GLYPH_H_
+
+#include <avr/io.h>
+
+#define GLYPH_SLOTS 8									// CGRAM characters of the ST7036
+#define GLYPH_NONE 0xFF									// No slot
+#define GLYPH_EMPTY 0									// Key of a slot that holds nothing known
+#define GLYPH_ROWS 8									// Pixel rows of a character cell, the last one is left for the cursor
+#define GLYPH_WIDTH 3									// Cells across one big character
+#define GLYPH_PITCH (GLYPH_WIDTH + 1)					// Cells from one big character to the next, with a blank column between them
+#define GLYPH_TEXT_COLS(n) ((n) * GLYPH_PITCH - 1)		// Cells across n big characters
+
+//***************************************************************************
+//
+// Function Name : void glyph_begin(void) & void glyph_end(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// glyph_begin starts a frame: the reference count of every slot goes back to 0, and the
+// frame gets the next time stamp. glyph_end ends it, and remembers which slots the frame
+// shows, so the next frame leaves them alone for as long as it can.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void glyph_begin(void);
+
+void glyph_end(void);
+
+//***************************************************************************
+//
+// Function Name : uint8_t glyph_use(uint16_t key)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns the slot that holds the glyph key, counts one more cell of the
+// frame that uses it and marks it as used by the frame. It returns GLYPH_NONE if the
+// glyph isn't in CGRAM.
+//
+// Warnings : none
+// Restrictions : key must not be GLYPH_EMPTY
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint8_t glyph_use(uint16_t key);
+
+//***************************************************************************
+//
+// Function Name : uint8_t glyph_load(uint16_t key, const uint8_t* rows)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function uploads the 8 pixel rows of the glyph key into a slot, counts the cell
+// that uses it and returns the slot. Only the rows that differ from the glyph the slot
+// held are sent. The slot is picked as shown below:
+// 1) Slots used by a cell of this frame are never taken
+// 2) An empty slot is taken first
+// 3) Then the least recently used slot that the last frame didn't show, so no cell on
+//	  the glass changes before its new character is written
+// 4) Then the least recently used of the rest
+// It returns GLYPH_NONE if every slot is used by this frame.
+//
+// Warnings : Call glyph_use for every cell of the frame first, so a glyph the frame
+//			  needs isn't replaced
+// Restrictions : The 5 low bits of each row are the pixels, left to right
+// Algorithms : glyph_write
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Sends only the rows that changed
+//
+//**************************************************************************
+
+uint8_t glyph_load(uint16_t key, const uint8_t* rows);
+
+//***************************************************************************
+//
+// Function Name : uint8_t glyph_write(uint8_t slot, const uint8_t* rows)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function redraws the glyph in slot with new pixel rows, keeping its key, for a
+// glyph that changes from one frame to the next. Only the run of rows from the first to
+// the last one that changed is sent, with one lcd_cgram_write. It returns 1 if anything
+// was sent.
+//
+// Warnings : Every cell that shows the slot changes with it
+// Restrictions : The 5 low bits of each row are the pixels, left to right
+// Algorithms : lcd_cgram_write
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint8_t glyph_write(uint8_t slot, const uint8_t* rows);
+
+//***************************************************************************
+//
+// Function Name : void glyph_reset(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function forgets what is in CGRAM, so every glyph is uploaded again when it is
+// next used. The ST7036 doesn't clear CGRAM at power up, so the slots start out empty
+// as far as the engine knows.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void glyph_reset(void);
+
+//***************************************************************************
+//
+// Function Name : uint8_t glyph_text(const char* text, int16_t x, uint8_t height, char* cells, uint8_t cols)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function draws text in big characters into cells, height rows of cols DDRAM
+// characters, as one glyph frame. The first character starts at column x, which can be
+// off the left edge, and whatever falls off either edge is cut. The steps are shown below:
+// 1) Works out the quarters of every cell from the 6 by 6 picture of its character.
+//	  Characters 2 rows tall use the picture's rows 0, 2, 3 and 5
+// 2) Uses the space and the full block for empty and full cells, and glyph_use for the
+//	  rest, keeping the cells whose glyph isn't in CGRAM yet
+// 3) Loads those glyphs with glyph_load. A cell that still has no slot, because the
+//	  frame needs more than 8 glyphs, gets the full block if at least 2 of its quarters
+//	  are filled and a space otherwise
+// Lower case letters are drawn as upper case, and characters with no picture as spaces.
+// It returns the number of glyphs uploaded.
+//
+// Warnings : none
+// Restrictions : height must be 2 or 3
+// Algorithms : glyph_begin, glyph_use, glyph_load, glyph_end
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint8_t glyph_text(const char* text, int16_t x, uint8_t height, char* cells, uint8_t cols);
+
+//***************************************************************************
+//
+// Function Name : uint8_t glyph_show(const char* text, int16_t x, uint8_t height)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function shows text in big characters across the canvas of DOG LCDs, from the top
+// row down, with glyph_text. Each row is brought up to date on every DOG LCD with
+// lcd_update_slices, so only the cells that changed are sent, taking turns between the
+// DOG LCDs. It returns the number of glyphs uploaded.
+//
+// Warnings : The DOG LCDs must be in the 3 line font
+// Restrictions : height must be 2 or 3
+// Algorithms : glyph_text, lcd_update_slices
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Rows sent to the DOG LCDs in turn
+//
+//**************************************************************************
+
+uint8_t glyph_show(const char* text, int16_t x, uint8_t height);
+
+//***************************************************************************
+//
+// Function Name : uint8_t glyph_slide(const char* const* rows, uint8_t line, char* cells, uint8_t cols)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function draws 3 rows of text moved up by line pixel lines into cells, 3 rows of
+// cols DDRAM characters, as one glyph frame. rows points to 4 rows of text, cols characters
+// each, and every cell shows the bottom of its character in one row over the top of the
+// character under it in the next. The steps are shown below:
+// 1) Uses the character itself when line is 0, and a space for a cell that comes out
+//	  blank, such as one between 2 spaces
+// 2) Uses glyph_use for the rest, with the pair of characters as the key, so a pair keeps
+//	  its slot for as long as it is on the glass
+// 3) Redraws every slot the frame uses at line pixel lines with glyph_write, and loads the
+//	  pairs that aren't in CGRAM yet with glyph_load. A cell that still has no slot, because
+//	  the frame has more than 8 pairs, shows the upper character until the text has moved
+//	  half a row, and the lower one after that
+// It returns the number of glyphs uploaded or redrawn.
+//
+// Warnings : none
+// Restrictions : line must be under GLYPH_ROWS
+// Algorithms : glyph_begin, glyph_use, glyph_write, glyph_load, glyph_end
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint8_t glyph_slide(const char* const* rows, uint8_t line, char* cells, uint8_t cols);
+
+//***************************************************************************
+//
+// Function Name : uint8_t glyph_slide_show(const char* const* rows, uint8_t line)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function shows 4 canvas rows moved up by line pixel lines across the DOG LCDs,
+// with glyph_slide. Each row is brought up to date on every DOG LCD with
+// lcd_update_slices, taking turns between them, and a row that is the same on every DOG
+// LCD is broadcast once with lcd_update_block. It returns 1 if anything was queued for
+// transmission.
+//
+// Warnings : The DOG LCDs must be in the 3 line font
+// Restrictions : line must be under GLYPH_ROWS, and the rows must be
+//				  LCD_PANELS * LCD_COLS characters
+// Algorithms : glyph_slide, lcd_update_block, lcd_update_slices
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Rows sent to the DOG LCDs in turn
+//
+//**************************************************************************
+
+uint8_t glyph_slide_show(const char* const* rows, uint8_t line);
+
+#endif /* GLYPH_H_ */
@@ -0,0 +1,567 @@
+//***************************************************************************
+//
+// File Name : layout.c
+// Title :
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This file defines the streaming layout engine. The same rules are built into the
+// firmware, which lays the rows out as the scroll reaches them, and into
+// tools/layout_gen.c, which uses them to write the flash row table. Every character is
+// read through get, which expands the dictionary tokens of the source.
+//
+// Warnings :
+// Restrictions : none
+// Algorithms : none
+// References :
+//
+// Revision History : Initial version
+//					  1.1 - Reads the source through get and peek
+//
+//
+//**************************************************************************
+
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#include "layout.h"
+
+#define RD(lay, pos) (pgm_read_byte(&(lay)->src[pos]))
+#define RD16(lay, pos) (RD(lay, pos) | (uint16_t)RD(lay, (pos) + 1) << 8)	// Offsets are stored low byte first
+
+//***************************************************************************
+//
+// Function Name : static char get(const layout_t* lay, layout_at_t* at) &
+//				   static char peek(const layout_t* lay, layout_at_t at)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// get returns the character at at and moves at past it. A byte of LAYOUT_TOKEN or more
+// is a dictionary token, whose characters are returned one at a time, counted off in
+// sub, before at moves on to the next byte. peek returns the same character without
+// moving at.
+//
+//**************************************************************************
+
+static char get(const layout_t* lay, layout_at_t* at) {
+	uint8_t b = RD(lay, at->pos);
+
+	if (b < LAYOUT_TOKEN) {
+		at->pos++;
+		return b;
+	}
+
+	uint16_t entry = 1 + 2 * (b - LAYOUT_TOKEN);				// Offset of the token, followed by the offset of the next one
+	uint16_t start = RD16(lay, entry);
+	char c = RD(lay, start + at->sub++);
+	if (start + at->sub == RD16(lay, entry + 2)) {				// Last character of the token
+		at->pos++;
+		at->sub = 0;
+	}
+	return c;
+}
+
+static char peek(const layout_t* lay, layout_at_t at) {
+	return get(lay, &at);
+}
+
+//***************************************************************************
+//
+// Function Name : static void next_section(layout_t* lay)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function reads the kind byte of the section at at and moves at to its body.
+// Text and names sections are counted in section. Kind bytes are never in a token.
+//
+//**************************************************************************
+
+static void next_section(layout_t* lay) {
+	lay->kind = RD(lay, lay->at.pos);
+	if (lay->kind != LAYOUT_END)
+		lay->at.pos++;
+	if ((lay->kind & LAYOUT_KIND) == LAYOUT_TEXT || (lay->kind & LAYOUT_KIND) == LAYOUT_NAMES)
+		lay->section++;
+}
+
+//***************************************************************************
+//
+// Function Name : static void full_row(char* row, uint8_t len, uint8_t cols)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function spreads the words of a row of len characters out to the right edge of
+// the canvas. The blank columns are shared out between the gaps between the words, the
+// gaps on the left getting one more if they don't share out evenly. The row is copied
+// once from its end back to its start, so every character is moved straight to where
+// it goes. A row with one word is left alone.
+//
+//**************************************************************************
+
+static void full_row(char* row, uint8_t len, uint8_t cols) {
+	uint8_t gaps = 0;
+
+	for (uint8_t j = 1; j < len; j++)							// Counts the gaps between words
+		if (row[j] == ' ' && row[j - 1] != ' ')
+			gaps++;
+	if (!gaps)
+		return;
+
+	uint8_t each = (cols - len) / gaps;
+	uint8_t more = (cols - len) % gaps;							// Gaps that get one more blank column
+	uint8_t to = cols;
+
+	for (uint8_t from = len; to > from; ) {						// Stops once nothing is left to move
+		char c = row[--from];
+		row[--to] = c;
+		if (c == ' ' && row[from - 1] != ' ') {					// First space of gap number gaps
+			for (uint8_t j = each + (--gaps < more); j > 0; j--)
+				row[--to] = ' ';
+		}
+	}
+}
+
+//***************************************************************************
+//
+// Function Name : static void align_row(layout_t* lay, char* row, uint8_t len, uint8_t last)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function lines a text row of len characters, starting at the left edge, up as the
+// section's kind byte says. Centered and right-justified rows are moved right by one
+// offset worked out from len, in one move. A centered row is moved by half of the blank
+// columns on the right half of the canvas, as the rows have always been. last is 1 for
+// the last row of a paragraph, which is left alone when the text is fully justified.
+//
+//**************************************************************************
+
+static void align_row(layout_t* lay, char* row, uint8_t len, uint8_t last) {
+	uint8_t cols = lay->cols;
+	uint8_t shift;
+
+	if (len == 0)
+		return;
+
+	switch (lay->kind & LAYOUT_ALIGN) {
+		case LAYOUT_CENTER:
+			shift = cols - len < cols / 2 - 1 ? cols - len : cols / 2 - 1;	// Blank columns on the right half
+			shift /= 2;
+			break;
+		case LAYOUT_RIGHT:
+			shift = cols - len;
+			break;
+		case LAYOUT_FULL:
+			if (!last)
+				full_row(row, len, cols);
+			return;
+		default:
+			return;
+	}
+
+	memmove(&row[shift], row, len);								// Shifts the row right in one move
+	memset(row, ' ', shift);
+}
+
+//***************************************************************************
+//
+// Function Name : static void text_row(layout_t* lay, char* row)
+// Date : 10/16/2026
+// Version : 1.5
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function fills row from a text section with a greedy word wrap, which sees every
+// DOG LCD as one line. The characters are read once, front to back, up to one past the
+// right edge, and fit keeps the end of the last word that was seen to fit, with fit_at
+// where it is in the source. The row then ends at fit, and the start of the word that
+// didn't fit is cleared to go on the next row. A '\n' or a LAYOUT_BREAK ends the row where
+// it is. A row that ends on the last character of the text moves the layout to the next
+// section. A full row leaves at where the next row starts, past any blank spaces, and
+// looks ahead there, so text that ends exactly at the right edge ends the section on that
+// row instead of leaving a blank row after it. The row is then lined up by align_row, as
+// the last row of its paragraph if it ends at a '\n' or at the end of the text.
+//
+// Revision History : Initial version
+//					  1.1 - One pass that finds the break before the row is cut, instead
+//							of backing up over the word that didn't fit, and forced breaks
+//					  1.2 - fit stops at the end of the word, and the row is lined up here
+//					  1.3 - Reads through get, keeping where fit is instead of adding it to pos
+//					  1.4 - Every paragraph's last row kept out of full justification
+//					  1.5 - No blank row after text that ends at the right edge
+//
+//**************************************************************************
+
+static void text_row(layout_t* lay, char* row) {
+	uint8_t fit = 0;											// Characters up to the end of the last word that fits
+	layout_at_t at, here, fit_at;
+	uint8_t col;
+	char c;
+
+	while (peek(lay, lay->at) == ' ')							// Skips any blank spaces at the beginning of a row
+		get(lay, &lay->at);
+
+	at = lay->at;
+	for (col = 0; ; col++) {
+		here = at;
+		c = get(lay, &at);
+		if ((c == ' ' || c == '\n' || c == LAYOUT_BREAK || c == '\0') && col && row[col - 1] != ' ') {	// Everything before c fits
+			fit = col;
+			fit_at = here;
+		}
+		if (c == '\n' || c == LAYOUT_BREAK || c == '\0' || col == lay->cols)
+			break;
+		row[col] = c;
+	}
+
+	if (c == '\n' || c == LAYOUT_BREAK || (c == '\0' && col < lay->cols)) {	// The rest of the paragraph or the row fits
+		memset(&row[fit], ' ', col - fit);						// Spaces after the last word
+		align_row(lay, row, fit, c != LAYOUT_BREAK);
+		lay->at = at;
+		if (c == '\0')
+			next_section(lay);
+		return;
+	}
+
+	if (!fit) {													// A word longer than the row is split at the right edge
+		fit = col;
+		fit_at = here;
+	}
+	memset(&row[fit], ' ', col - fit);							// The word that didn't fit goes on the next row
+	lay->at = fit_at;
+	while (peek(lay, lay->at) == ' ')							// Skips the blank spaces the next row would skip
+		get(lay, &lay->at);
+	c = peek(lay, lay->at);
+	align_row(lay, row, fit, c == '\0');
+	if (c == '\0') {											// The text ends at the right edge
+		get(lay, &lay->at);
+		next_section(lay);
+	}
+}
+
+//***************************************************************************
+//
+// Function Name : static void names_row(layout_t* lay, char* row)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function fills row with the next name of a names section. The first name ends at
+// the middle of the canvas, and the rest of the name starts there. Either part is cut
+// off at half of the canvas.
+//
+// Revision History : Initial version
+//					  1.1 - Reads the name once through get, and moves the first name
+//							into place afterwards
+//
+//**************************************************************************
+
+static void names_row(layout_t* lay, char* row) {
+	uint8_t half = lay->cols / 2;
+	uint8_t len = 0;
+	char c;
+
+	while ((c = get(lay, &lay->at)) != ' ' && c != '\n' && c != '\0')	// Copies the first name to the start of the row
+		if (len < half)
+			row[len++] = c;
+
+	memmove(&row[half - len], row, len);						// Right-justified on the left half
+	memset(row, ' ', half - len);
+
+	if (c == ' ')
+		for (uint8_t j = half; (c = get(lay, &lay->at)) != '\n' && c != '\0'; )	// Left-justified on the right half
+			if (j < lay->cols)
+				row[j++] = c;
+
+	if (c == '\n') {
+		if (peek(lay, lay->at) != '\0')							// More names follow
+			return;
+		get(lay, &lay->at);
+	}
+	next_section(lay);											// That was the last name
+}
+
+//***************************************************************************
+//
+// Function Name : void layout_start(layout_t* lay, const char* src, uint8_t cols)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function points the layout at the first row of a source stream, for a canvas of
+// cols characters. The first section starts where the dictionary ends.
+//
+// Warnings : none
+// Restrictions : cols must be even
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Skips the dictionary
+//
+//**************************************************************************
+
+void layout_start(layout_t* lay, const char* src, uint8_t cols) {
+	lay->src = src;
+	lay->at.pos = RD16(lay, 1 + 2 * RD(lay, 0));				// End of the last token
+	lay->at.sub = 0;
+	lay->row = 0;
+	lay->section = 0;
+	lay->cols = cols;
+	next_section(lay);
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t layout_next(layout_t* lay, char* row)
+// Date : 10/16/2026
+// Version : 1.2
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function writes the next canvas row into row, cols characters with no null
+// character, and moves the layout past it. Text rows follow the rules shown below:
+// 1) Spaces at the beginning of a row are removed
+// 2) A word that would be cut off at the right edge of the last DOG LCD is moved to the
+//	  next row as a whole. A word longer than the row is split at the edge, and a '\n'
+//	  ends the row
+// 3) The row is lined up as its section's kind byte says, as it is made: moved right
+//	  by one offset (half of the blank columns of the right half of the canvas to
+//	  center it), or spread out to fill the row
+// Once the source is used up the rows are blank. It returns 1 if the row has a character
+// other than a space on it.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Text rows lined up by text_row as they are made, instead of
+//							every row being centered afterwards
+//					  1.2 - Reads through get
+//
+//**************************************************************************
+
+uint8_t layout_next(layout_t* lay, char* row) {
+	memset(row, ' ', lay->cols);
+	lay->row++;
+
+	for (;;) {
+		switch (lay->kind & LAYOUT_KIND) {
+			case LAYOUT_TEXT:
+				text_row(lay, row);
+				break;
+			case LAYOUT_NAMES:
+				if (peek(lay, lay->at) == '\0') {				// No names in the section
+					get(lay, &lay->at);
+					next_section(lay);
+					continue;
+				}
+				names_row(lay, row);
+				break;
+			case LAYOUT_BLANK:
+				next_section(lay);
+				return 0;
+			default:
+				return 0;
+		}
+		break;
+	}
+
+	for (uint8_t j = 0; j < lay->cols; j++)
+		if (row[j] != ' ')
+			return 1;
+	return 0;
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t layout_more(const layout_t* lay)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns 1 if any of the rows layout_next has not made yet has a character
+// on it, so a scroll can tell that it has reached the end without laying out the blank
+// rows that follow.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Reads through get
+//
+//**************************************************************************
+
+uint8_t layout_more(const layout_t* lay) {
+	layout_at_t at = lay->at;
+	uint8_t kind = lay->kind;
+	char c;
+
+	for (;;) {
+		switch (kind & LAYOUT_KIND) {
+			case LAYOUT_TEXT:
+				while ((c = get(lay, &at)) != '\0')
+					if (c != ' ' && c != '\n' && c != LAYOUT_BREAK)
+						return 1;
+				break;
+			case LAYOUT_NAMES:
+				if (get(lay, &at) != '\0')
+					return 1;
+				break;
+			case LAYOUT_BLANK:
+				break;
+			default:
+				return 0;
+		}
+		kind = get(lay, &at);									// Kind byte of the next section
+	}
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t layout_balance(char* text, uint8_t cols, layout_word_t* words, uint16_t size)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function picks the row breaks of a text for a canvas of cols characters so that
+// the rows come out as even as possible, instead of filling each row up as far as it goes.
+// The chosen breaks are written into the text as LAYOUT_BREAK, in place of the space after
+// the last word of each row, so layout_next shows the same rows from then on, and can
+// still tell them apart from the '\n' that end the paragraphs. The steps are shown below:
+// 1) Finds the start and end of every word, and the '\n' already in the text. The
+//	  LAYOUT_BREAK of an earlier balance are taken as spaces
+// 2) Going from the last word back to the first, works out the cheapest way to lay out
+//	  the text from each word on: every way of putting the next few words on one row,
+//	  plus the cheapest way from the word after them, already known. A row costs the
+//	  square of its blank columns, except the last row of a paragraph, which is free
+// 3) Follows the cheapest breaks from the first word and writes them into the text
+// Only the words that fit on one row are tried at each step, so the time grows
+// linearly with the length of the text. A word longer than a row is given a row of
+// its own, and split by layout_next. It returns 0 without changing the text if it has
+// more than size words.
+//
+// Warnings : words must have room for size entries
+// Restrictions : The text must be in RAM
+// Algorithms : Minimum raggedness line breaking, by dynamic programming
+// References : D. E. Knuth & M. F. Plass, Breaking Paragraphs into Lines
+//
+// Revision History : Initial version
+//					  1.1 - Breaks written as LAYOUT_BREAK
+//
+//**************************************************************************
+
+uint8_t layout_balance(char* text, uint8_t cols, layout_word_t* words, uint16_t size) {
+	uint16_t n = 0;
+
+	for (uint16_t i = 0; text[i] != '\0'; ) {					// Finds the words
+		if (text[i] == ' ' || text[i] == '\n' || text[i] == LAYOUT_BREAK) {
+			if (text[i] == '\n' && n)
+				words[n - 1].newline = 1;
+			i++;
+			continue;
+		}
+		if (n == size)
+			return 0;
+		words[n].start = i;
+		while (text[i] != ' ' && text[i] != '\n' && text[i] != LAYOUT_BREAK && text[i] != '\0')
+			i++;
+		words[n].end = i;
+		words[n++].newline = 0;
+	}
+
+	for (uint16_t i = n; i-- > 0; ) {							// Cheapest layout from each word on
+		words[i].cost = UINT32_MAX;
+		for (uint16_t j = i + 1; j <= n; j++) {					// Words i to j - 1 on one row
+			uint16_t len = words[j - 1].end - words[i].start;
+			if (len > cols && j > i + 1)
+				break;
+			uint8_t last = j == n || words[j - 1].newline;		// Last row of a paragraph
+			uint32_t cost = last || len > cols ? 0 : (uint32_t)(cols - len) * (cols - len);
+			if (j < n)
+				cost += words[j].cost;
+			if (cost < words[i].cost) {
+				words[i].cost = cost;
+				words[i].next = j;
+			}
+			if (last)
+				break;
+		}
+	}
+
+	for (uint16_t i = 0; text[i] != '\0'; i++)					// Drops the breaks of an earlier balance
+		if (text[i] == LAYOUT_BREAK)
+			text[i] = ' ';
+	for (uint16_t i = 0; i < n; i = words[i].next) {			// Writes the breaks
+		uint16_t j = words[i].next;
+		if (j < n && !words[j - 1].newline)
+			text[words[j - 1].end] = LAYOUT_BREAK;
+	}
+	return 1;
+}
+
+//***************************************************************************
+//
+// Function Name : void layout_mark(const layout_t* lay, layout_mark_t* mark) &
+//				   void layout_seek(layout_t* lay, const layout_mark_t* mark)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// layout_mark saves where the layout is, and layout_seek puts a layout of the same source
+// and width back there, so that layout_next carries on from the row that was next when the
+// checkpoint was made. Since nothing else carries over from one row to the next, any row
+// can be laid out again from the nearest checkpoint before it.
+//
+// Warnings : The checkpoint must come from a layout of the same source and width
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void layout_mark(const layout_t* lay, layout_mark_t* mark) {
+	mark->at = lay->at;
+	mark->row = lay->row;
+	mark->kind = lay->kind;
+	mark->section = lay->section;
+}
+
+void layout_seek(layout_t* lay, const layout_mark_t* mark) {
+	lay->at = mark->at;
+	lay->row = mark->row;
+	lay->kind = mark->kind;
+	lay->section = mark->section;
+}
@@ -0,0 +1,257 @@
+//***************************************************************************
+//
+// File Name : layout.h
+// Title :
+// Date : 10/16/2026
+// Version : 1.2
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This header file declares the streaming layout engine, which lays the messages out
+// across the canvas of DOG LCDs one row at a time, on demand. The canvas is one row of
+// text across every DOG LCD on the wall, LCD0 on the left, so it is 16 columns per
+// DOG LCD wide. Nothing but the current position in the source is kept between rows,
+// so the length of the content is only limited by the flash it takes.
+//
+// The source is one byte stream in flash. It starts with a dictionary of up to 128
+// tokens, strings of characters that come up often in the messages:
+// 1) The number of tokens, n
+// 2) n + 1 offsets from the start of the source, 2 bytes each with the low byte first:
+//	  where the characters of each token start, and where the last one ends
+// 3) The characters of the tokens, one after another. The sections start where they end
+// Within the sections, a byte of LAYOUT_TOKEN or more stands for the characters of token
+// byte - LAYOUT_TOKEN, so the messages take a lot less flash. The layout engine expands
+// the tokens as it reads, one character at a time, so it takes the same RAM for any
+// amount of content. The sections each start with a kind byte:
+// LAYOUT_TEXT -> Text up to a null character, split into rows at the spaces. A '\n' ends
+//				  a row early and ends the paragraph, and a LAYOUT_BREAK ends a row early
+//				  within the paragraph. The kind byte also holds how the rows are lined up:
+//				  LAYOUT_CENTER (the default), LAYOUT_LEFT, LAYOUT_RIGHT or LAYOUT_FULL
+// LAYOUT_NAMES -> Names that each end with '\n', up to a null character. The first name
+//				   is right-justified on the left half of the canvas and the rest of the
+//				   name left-justified on the right half, one name per row
+// LAYOUT_BLANK -> One blank row
+// LAYOUT_END -> End of the source
+// tools/layout_gen.c builds the source from messages.h and writes it to layout_rows.h.
+//
+// Warnings :
+// Restrictions : The source must be in the first 64 KB of flash, and the characters of
+//				  the messages must be below LAYOUT_TOKEN
+// Algorithms : Byte pair encoding, flattened so every token is a plain string
+// References : P. Gage, A New Algorithm for Data Compression
+//
+// Revision History : Initial version
+//					  1.1 - Dictionary tokens in the source
+//					  1.2 - LAYOUT_BREAK
+//
+//**************************************************************************
+
+#ifndef LAYOUT_H_
+#define LAYOUT_H_
+
+#include <avr/io.h>
+
+// Section kinds of the source stream
+#define LAYOUT_END 0
+#define LAYOUT_TEXT 1
+#define LAYOUT_NAMES 2
+#define LAYOUT_BLANK 3
+#define LAYOUT_KIND 0x0F								// Bits of the kind byte that hold the kind
+
+// How the rows of a text section are lined up, ORed into its kind byte
+#define LAYOUT_CENTER 0x00								// Centered on the blank columns of the right half
+#define LAYOUT_LEFT 0x10
+#define LAYOUT_RIGHT 0x20
+#define LAYOUT_FULL 0x30								// Spaces added between the words to fill the row, the last row of each paragraph left
+#define LAYOUT_ALIGN 0x30								// Bits of the kind byte that hold the alignment
+
+#define LAYOUT_BREAK '\r'								// Row break written by layout_balance, which doesn't end the paragraph
+
+#define LAYOUT_TOKEN 0x80								// First byte that stands for a dictionary token
+#define LAYOUT_TOKEN_MAX 16								// Most characters in one token
+
+// Place in the source stream, sub characters into the byte at pos if it is a token
+typedef struct {
+	uint16_t pos;
+	uint8_t sub;
+} layout_at_t;
+
+// Position of the layout in the source, everything needed to carry on from the next row
+typedef struct {
+	const char* src;									// Source stream in flash
+	layout_at_t at;										// Next character of the section body to lay out
+	uint16_t row;										// Canvas row layout_next makes next
+	uint8_t kind;										// Kind byte of the section at is in, LAYOUT_END once the source is used up
+	uint8_t section;									// Text and names sections started so far, counting the one pos is in
+	uint8_t cols;										// Canvas width in characters
+} layout_t;
+
+// One word of a text being balanced by layout_balance
+typedef struct {
+	uint16_t start;										// Offset of the first character
+	uint16_t end;										// Offset just past the last character
+	uint16_t next;										// First word of the row after the one this word starts
+	uint32_t cost;										// Least cost of laying out the text from this word on
+	uint8_t newline;									// A '\n' follows the word
+} layout_word_t;
+
+// Checkpoint of a layout at the start of a row, to lay the canvas out again from there
+typedef struct {
+	layout_at_t at;
+	uint16_t row;
+	uint8_t kind;
+	uint8_t section;
+} layout_mark_t;
+
+//***************************************************************************
+//
+// Function Name : void layout_start(layout_t* lay, const char* src, uint8_t cols)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function points the layout at the first row of a source stream, for a canvas of
+// cols characters. The first section starts where the dictionary ends.
+//
+// Warnings : none
+// Restrictions : cols must be even
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Skips the dictionary
+//
+//**************************************************************************
+
+void layout_start(layout_t* lay, const char* src, uint8_t cols);
+
+//***************************************************************************
+//
+// Function Name : uint8_t layout_next(layout_t* lay, char* row)
+// Date : 10/16/2026
+// Version : 1.2
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function writes the next canvas row into row, cols characters with no null
+// character, and moves the layout past it. Text rows follow the rules shown below:
+// 1) Spaces at the beginning of a row are removed
+// 2) A word that would be cut off at the right edge of the last DOG LCD is moved to the
+//	  next row as a whole. A word longer than the row is split at the edge, and a '\n'
+//	  ends the row
+// 3) The row is lined up as its section's kind byte says, as it is made: moved right
+//	  by one offset (half of the blank columns of the right half of the canvas to
+//	  center it), or spread out to fill the row
+// Once the source is used up the rows are blank. It returns 1 if the row has a character
+// other than a space on it.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Text rows lined up by text_row as they are made, instead of
+//							every row being centered afterwards
+//					  1.2 - Reads through get
+//
+//**************************************************************************
+
+uint8_t layout_next(layout_t* lay, char* row);
+
+//***************************************************************************
+//
+// Function Name : uint8_t layout_more(const layout_t* lay)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns 1 if any of the rows layout_next has not made yet has a character
+// on it, so a scroll can tell that it has reached the end without laying out the blank
+// rows that follow.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - Reads through get
+//
+//**************************************************************************
+
+uint8_t layout_more(const layout_t* lay);
+
+//***************************************************************************
+//
+// Function Name : uint8_t layout_balance(char* text, uint8_t cols, layout_word_t* words, uint16_t size)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function picks the row breaks of a text for a canvas of cols characters so that
+// the rows come out as even as possible, instead of filling each row up as far as it goes.
+// The chosen breaks are written into the text as LAYOUT_BREAK, in place of the space after
+// the last word of each row, so layout_next shows the same rows from then on, and can
+// still tell them apart from the '\n' that end the paragraphs. The steps are shown below:
+// 1) Finds the start and end of every word, and the '\n' already in the text. The
+//	  LAYOUT_BREAK of an earlier balance are taken as spaces
+// 2) Going from the last word back to the first, works out the cheapest way to lay out
+//	  the text from each word on: every way of putting the next few words on one row,
+//	  plus the cheapest way from the word after them, already known. A row costs the
+//	  square of its blank columns, except the last row of a paragraph, which is free
+// 3) Follows the cheapest breaks from the first word and writes them into the text
+// Only the words that fit on one row are tried at each step, so the time grows
+// linearly with the length of the text. A word longer than a row is given a row of
+// its own, and split by layout_next. It returns 0 without changing the text if it has
+// more than size words.
+//
+// Warnings : words must have room for size entries
+// Restrictions : The text must be in RAM
+// Algorithms : Minimum raggedness line breaking, by dynamic programming
+// References : D. E. Knuth & M. F. Plass, Breaking Paragraphs into Lines
+//
+// Revision History : Initial version
+//					  1.1 - Breaks written as LAYOUT_BREAK
+//
+//**************************************************************************
+
+uint8_t layout_balance(char* text, uint8_t cols, layout_word_t* words, uint16_t size);
+
+//***************************************************************************
+//
+// Function Name : void layout_mark(const layout_t* lay, layout_mark_t* mark) &
+//				   void layout_seek(layout_t* lay, const layout_mark_t* mark)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// layout_mark saves where the layout is, and layout_seek puts a layout of the same source
+// and width back there, so that layout_next carries on from the row that was next when the
+// checkpoint was made. Since nothing else carries over from one row to the next, any row
+// can be laid out again from the nearest checkpoint before it.
+//
+// Warnings : The checkpoint must come from a layout of the same source and width
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void layout_mark(const layout_t* lay, layout_mark_t* mark);
+
+void layout_seek(layout_t* lay, const layout_mark_t* mark);
+
+#endif /* LAYOUT_H_ */
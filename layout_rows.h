@@ -0,0 +1,175 @@
+//***************************************************************************
+//
+// File Name : layout_rows.h
+//
+// Generated by tools/layout_gen.c from messages.h, do not edit.
+//
+//**************************************************************************
+
+#ifndef LAYOUT_ROWS_H_
+#define LAYOUT_ROWS_H_
+
+#include <avr/pgmspace.h>
+
+#define LAYOUT_PANELS 2							// DOG LCDs across the canvas
+#define LAYOUT_COLS 16							// Columns on each DOG LCD
+#define LAYOUT_ROWS 39							// Rows the down scroll can bring to the top
+#define LAYOUT_TABLE_ROWS 41
+#define LAYOUT_SOURCE_SIZE 528						// Bytes of layout_source, 562 before compression with 11 tokens
+#define LAYOUT_SECTIONS 3						// Text and names sections, for scroll_jump
+#define LAYOUT_SECTION_MESSAGE 0
+#define LAYOUT_SECTION_NAMES 1
+#define LAYOUT_SECTION_THANKS 2
+
+#define SHOW_STEPS 38							// Steps of the down scroll, one for each row it moves
+#define SHOW_STREAM_SIZE 2330						// Bytes of show_stream, 1801 bytes on the bus
+#define SHOW_BUS_US 26694						// Time the steps keep the bus busy, 1315 us in the longest one
+#define SHOW_MS 20000							// Length of the show, at SCROLLSPEED with the SCROLLHOLD at the end
+#define SHOW_STEP 0x00							// Ends the records of one step
+#define SHOW_ALL 0x40							// Run broadcast to every DOG LCD
+#define SHOW_EACH 0x80							// Runs of one row for each DOG LCD, each list ended by a 0 byte
+#define SHOW_KIND 0xC0
+#define SHOW_LEN 0x1F
+
+static const char layout_source[LAYOUT_SOURCE_SIZE] PROGMEM =
+	"\013\031\000\033\000\035\000\037\000!\000#\000%\000'\000)\000+\000-\000/\000"
+	"an"
+	"e "
+	"in"
+	"ar"
+	"on"
+	" W"
+	"en"
+	"er"
+	"th"
+	"ou"
+	"ri"
+	"\001Th\200k y\211 for teach\202g us, \210r\211gh good heal\210 \200d sickness, y\211'v\201always be\206 \210\207\201\200d w\201appreciat\201y\211.\205\201hop\201y\211 get bett\207 so\204\000"
+	"\003"
+	"\003"
+	"\003"
+	"\002Dyl\200\205\204g\n"
+	"St\200ley Cokro\n"
+	"Nisat Nos\202\n"
+	"Luk\201Melfa\n"
+	"E\212c Y\200g\n"
+	"F\203ha\200 Kh\200\n"
+	"Johns\204 V\203ghese\n"
+	"Hill\203y Ng\n"
+	"John Sh\202\n"
+	"B\206\205\206g\n"
+	"Savi Kessl\207\n"
+	"K\206ny Procacci\n"
+	"Shaun V\203ghese\n"
+	"Ch\212st\202a\205\204g\n"
+	"Mahima K\203\200\210\n"
+	"A\212tro S\203k\203\n"
+	"Kyl\201H\200\n"
+	"Sp\206c\207\205u\n"
+	"Rachel Le\204g\n"
+	"Natali\201Sid\n"
+	"Dilshoda Sayfillaeva\n"
+	"Alex\200d\207 M\204ov\n"
+	"Pr\200ay S\212vastava\n"
+	"Ka\210\207\202\201Trus\202ski\n"
+	"E\212c\205u\n"
+	"Dev\202 Lee\n\000"
+	"\003"
+	"\003"
+	"\003"
+	"\001Special Th\200ks to Bry\200t G\204zaga for org\200iz\202g \210is stud\206t project\000"
+	"\003"
+	"\003"
+	"\003"
+;
+
+static const uint16_t layout_section_rows[LAYOUT_SECTIONS] PROGMEM = { 0, 8, 37 };
+
+static const char layout_rows[LAYOUT_TABLE_ROWS][LAYOUT_PANELS * LAYOUT_COLS] PROGMEM = {
+	"   Thank you for teaching us,   ",
+	"    through good health and     ",
+	"  sickness, you've always been  ",
+	"there and we appreciate you. We ",
+	"    hope you get better soon    ",
+	"                                ",
+	"                                ",
+	"                                ",
+	"           DylanWong            ",
+	"         StanleyCokro           ",
+	"           NisatNosin           ",
+	"            LukeMelfa           ",
+	"            EricYang            ",
+	"         FarhaanKhan            ",
+	"         JohnsonVarghese        ",
+	"         HillaryNg              ",
+	"            JohnShin            ",
+	"             BenWeng            ",
+	"            SaviKessler         ",
+	"           KennyProcacci        ",
+	"           ShaunVarghese        ",
+	"       ChristinaWong            ",
+	"          MahimaKaranth         ",
+	"          AritroSarkar          ",
+	"            KyleHan             ",
+	"         SpencerWu              ",
+	"          RachelLeong           ",
+	"         NatalieSid             ",
+	"        DilshodaSayfillaeva     ",
+	"       AlexanderMonov           ",
+	"          PranaySrivastava      ",
+	"       KatherineTrusinski       ",
+	"            EricWu              ",
+	"           DevinLee             ",
+	"                                ",
+	"                                ",
+	"                                ",
+	"Special Thanks to Bryant Gonzaga",
+	"  for organizing this student   ",
+	"       project                  ",
+	"                                "
+};
+
+static const uint16_t show_steps[SHOW_STEPS] PROGMEM = { 0, 106, 218, 312, 368, 386, 403, 439, 494, 550, 603, 655, 711, 773, 835, 890, 941, 994, 1053, 1118, 1185, 1252, 1314, 1371, 1427, 1483, 1547, 1619, 1698, 1778, 1856, 1923, 1976, 2004, 2017, 2057, 2136, 2248 };
+
+static const char show_stream[SHOW_STREAM_SIZE] PROGMEM =
+	"\200\015\203 through good\000\001\201h\011\204lth and  \000\200\016\222sickness, you'\000\003\220ve \011\225ways been\000\200\020\240there and we app\000\017\240reciate you. We\000\000"
+	"\200\016\202sickness, you'\000\003\200ve \011\205ways been\000\200\020\220there and we app\000\017\220reciate you. We\000\200\020\240    hope you get\000\017\240 better soon   \000\000"
+	"\200\020\200there and we app\000\017\200reciate you. We\000\200\020\220    hope you get\000\017\220 better soon   \000O\241               \000"
+	"\200\020\200    hope you get\000\017\200 better soon   \000O\221               \000"
+	"O\201               \000"
+	"\200\005\253Dylan\000\004\240Wong\000\000"
+	"\200\005\233Dylan\000\004\220Wong\000\200\007\251Stanley\000\005\240Cokro\000\000"
+	"\200\005\213Dylan\000\004\200Wong\000\200\007\231Stanley\000\005\220Cokro\000\200\007\251  Nisat\000\005\240Nosin\000\000"
+	"\200\007\211Stanley\000\005\200Cokro\000\200\007\231  Nisat\000\005\220Nosin\000\200\005\253 Luke\000\005\240Melfa\000\000"
+	"\200\007\211  Nisat\000\005\200Nosin\000\200\005\233 Luke\000\005\220Melfa\000\200\004\254Eric\000\005\240Yang \000\000"
+	"\200\005\213 Luke\000\005\200Melfa\000\200\004\234Eric\000\005\220Yang \000\200\007\251Farhaan\000\004\240Khan\000\000"
+	"\200\004\214Eric\000\005\200Yang \000\200\007\231Farhaan\000\004\220Khan\000\200\006\251Johnso\000\010\240Varghese\000\000"
+	"\200\007\211Farhaan\000\004\200Khan\000\200\006\231Johnso\000\010\220Varghese\000\200\007\251Hillary\000\010\240Ng      \000\000"
+	"\200\006\211Johnso\000\010\200Varghese\000\200\007\231Hillary\000\010\220Ng      \000\200\007\251   John\000\004\240Shin\000\000"
+	"\200\007\211Hillary\000\010\200Ng      \000\200\007\231   John\000\004\220Shin\000\200\003\254 Be\000\004\240Weng\000\000"
+	"\200\007\211   John\000\004\200Shin\000\200\003\234 Be\000\004\220Weng\000\200\004\254Savi\000\007\240Kessler\000\000"
+	"\200\003\214 Be\000\004\200Weng\000\200\004\234Savi\000\007\220Kessler\000\200\005\253Kenny\000\010\240Procacci\000\000"
+	"\200\004\214Savi\000\007\200Kessler\000\200\005\233Kenny\000\010\220Procacci\000\200\005\253Shaun\000\010\240Varghese\000\000"
+	"\200\005\213Kenny\000\010\200Procacci\000\200\005\233Shaun\000\010\220Varghese\000\200\011\247Christina\000\010\240Wong    \000\000"
+	"\200\005\213Shaun\000\010\200Varghese\000\200\011\227Christina\000\010\220Wong    \000\200\010\247   Mahim\000\007\240Karanth\000\000"
+	"\200\011\207Christina\000\010\200Wong    \000\200\010\227   Mahim\000\007\220Karanth\000\200\006\252Aritro\000\001\240S\004\243kar \000\000"
+	"\200\010\207   Mahim\000\007\200Karanth\000\200\006\232Aritro\000\001\220S\004\223kar \000\200\006\252  Kyle\000\006\240Han   \000\000"
+	"\200\006\212Aritro\000\001\200S\004\203kar \000\200\006\232  Kyle\000\006\220Han   \000\200\007\251Spencer\000\003\240Wu \000\000"
+	"\200\006\212  Kyle\000\006\200Han   \000\200\007\231Spencer\000\003\220Wu \000\200\007\251 Rachel\000\005\240Leong\000\000"
+	"\200\007\211Spencer\000\003\200Wu \000\200\007\231 Rachel\000\005\220Leong\000\200\007\251Natalie\000\005\240Sid  \000\000"
+	"\200\007\211 Rachel\000\005\200Leong\000\200\007\231Natalie\000\005\220Sid  \000\200\010\250Dilshoda\000\n\241ayfillaeva\000\000"
+	"\200\007\211Natalie\000\005\200Sid  \000\200\010\230Dilshoda\000\n\221ayfillaeva\000\200\011\247Alexander\000\013\240Monov      \000\000"
+	"\200\010\210Dilshoda\000\n\201ayfillaeva\000\200\011\227Alexander\000\013\220Monov      \000\200\011\247   Pranay\000\n\240Srivastava\000\000"
+	"\200\011\207Alexander\000\013\200Monov      \000\200\011\227   Pranay\000\n\220Srivastava\000\200\011\247Katherine\000\n\240Trusinski \000\000"
+	"\200\011\207   Pranay\000\n\200Srivastava\000\200\011\227Katherine\000\n\220Trusinski \000\200\011\247     Eric\000\011\240Wu       \000\000"
+	"\200\011\207Katherine\000\n\200Trusinski \000\200\011\227     Eric\000\011\220Wu       \000\200\005\253Devin\000\003\240Lee\000\000"
+	"\200\011\207     Eric\000\011\200Wu       \000\200\005\233Devin\000\003\220Lee\000C\240   E\253     \000"
+	"\200\005\213Devin\000\003\200Lee\000C\220   E\233     \000"
+	"C\200   E\213     \000"
+	"\200\020\240Special Thanks t\000\020\240o Bryant Gonzaga\000\000"
+	"\200\020\220Special Thanks t\000\020\220o Bryant Gonzaga\000\200\020\240  for organizing\000\020\240 this student   \000\000"
+	"\200\020\200Special Thanks t\000\020\200o Bryant Gonzaga\000\200\020\220  for organizing\000\020\220 this student   \000\200\016\242     project  \000\014\241            \000\000"
+	"\200\020\200  for organizing\000\020\200 this student   \000\200\016\222     project  \000\014\221            \000G\247       \000"
+;
+
+#endif /* LAYOUT_ROWS_H_ */
@@ -48,48 +48,30 @@
 //**************************************************************************
 #include <avr/interrupt.h>		
 
-#include "messages.h"																			
 #include "DOGM163WA.h"
 #include "functions.h"
+#include "events.h"
 
 int main(void) {
-	//_delay_ms(500);
-	//init_lcd_dog();							// Configures LCDs
-	init_big_lcd_dog();
-	exit(1);
-	PORTB.DIRCLR |= PIN2_bm;				// Configures PB2 (On-board active low pushbutton) as an input
-	PORTB.PIN2CTRL |= PIN0_bm | PIN1_bm;	// Enables Interrupt on falling edge 
-	PORTB.INTFLAGS |= PIN2_bm;				// Clears the Interrupt flag on PB2
+	init_lcd_dog();							// Configures LCDs
 	
-	insert_split_msg(message);
-	repeat(insert_newline, 3);
+	init_events();							// Configures the PB2 pushbutton and the time stamp clock
 	
-	insert_split_names(names);
-	repeat(insert_newline, 3);
-	
-	insert_split_msg(special_thanks);
-	repeat(insert_newline, 3);
-	
-	center_justify(lcd0_buff, lcd1_buff);
-	
-	still_display();
-	
-	sei();									// Enables global interrupts
+	sei();									// Enables global interrupts
+	
+	display_clock(SYSCLK_FAST_MHZ);			// Builds and sends the first frame at full speed
 	
 	while (1) {
-		still_display();
-		asm volatile ("nop");
+		if (event_pending() || scroll_pending())
+			display_clock(SYSCLK_FAST_MHZ);	// A new frame is coming, raises the clock before building it
+		
+		dispatch_events();					// Acts on pushbutton presses posted by the PORTB interrupt
+		
+		display_service();					// Advances the scroll on each RTC tick, or draws the still display once it is due
+		
+		idle_sleep();						// Sleeps until an interrupt brings in more work
 	}
 	
 }
 
-ISR (PORTB_PORT_vect) {
-	cli();									// Disables global interrupts
-
-	down_scroll_display();
-		
-	PORTB.INTFLAGS |= PIN2_bm;				// Clears the Interrupt flag
-	sei();									// Re-enables global interrupts
-}
-
 
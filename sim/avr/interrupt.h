@@ -0,0 +1,35 @@
+//***************************************************************************
+//
+// File Name : avr/interrupt.h (simulator)
+// Title : Host interrupt layer for the DOGM163 simulator
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// ISR() turns each interrupt handler into a plain function that the simulator
+// calls when the peripheral's flag and enable bits are set and the global
+// interrupt flag in SREG is set. sei() and cli() set and clear that flag.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//
+//**************************************************************************
+
+#ifndef SIM_AVR_INTERRUPT_H_
+#define SIM_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+#define ISR(vector, ...) void vector (void); void vector (void)
+
+#define sei() (SREG |= CPU_I_bm)
+#define cli() (SREG &= ~CPU_I_bm)
+
+#endif /* SIM_AVR_INTERRUPT_H_ */
@@ -0,0 +1,265 @@
+//***************************************************************************
+//
+// File Name : avr/io.h (simulator)
+// Title : Host register layer for the DOGM163 simulator
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This header stands in for <avr/io.h> when the firmware is built on the host.
+// The AVR128DB48 peripherals used by the firmware are declared with the same
+// register and bit names as the device header. Every peripheral access goes
+// through sim_io(), which lets the simulator advance time, finish SPI transfers
+// and run pending interrupts, so polling loops behave like they do on the part.
+//
+// Warnings : Only the registers and bits the firmware uses are modelled
+// Restrictions : none
+// Algorithms : none
+// References : AVR128DB48 datasheet, register summary
+//
+// Revision History : Initial version
+//
+//
+//**************************************************************************
+
+#ifndef SIM_AVR_IO_H_
+#define SIM_AVR_IO_H_
+
+#include <stdint.h>
+
+// Interrupt flag registers are wider than on the part. The simulator keeps a marker
+// in the high byte, so a firmware write (which clears the flags written as 1) can be
+// told apart from the flags the simulator set. Flags must be cleared by assignment.
+typedef volatile uint16_t sim_flags_t;
+
+typedef struct {
+	volatile uint8_t DIR, OUT, IN;
+	sim_flags_t INTFLAGS;
+} VPORT_t;
+
+typedef struct {
+	volatile uint8_t DIR, DIRSET, DIRCLR, DIRTGL;
+	volatile uint8_t OUT, OUTSET, OUTCLR, OUTTGL;
+	volatile uint8_t IN;
+	sim_flags_t INTFLAGS;
+	volatile uint8_t PORTCTRL, PINCONFIG;
+	volatile uint8_t PIN0CTRL, PIN1CTRL, PIN2CTRL, PIN3CTRL, PIN4CTRL, PIN5CTRL, PIN6CTRL, PIN7CTRL;
+} PORT_t;
+
+typedef struct {
+	volatile uint8_t CTRLA, CTRLB, INTCTRL;
+	sim_flags_t INTFLAGS;
+	volatile uint16_t DATA;					// Wider than the device register so writes can be detected
+} SPI_t;
+
+typedef struct {
+	volatile uint8_t RXDATAL, RXDATAH;
+	volatile uint16_t TXDATAL;				// Wider than the device register so writes can be detected
+	volatile uint8_t TXDATAH;
+	sim_flags_t STATUS;
+	volatile uint8_t CTRLA, CTRLB, CTRLC;
+	volatile uint16_t BAUD;
+	volatile uint8_t CTRLD, DBGCTRL, EVCTRL, TXPLCTRL, RXPLCTRL;
+} USART_t;
+
+typedef struct {
+	volatile uint8_t EVSYSROUTEA, CCLROUTEA, USARTROUTEA, USARTROUTEB, SPIROUTEA, TWIROUTEA, TCAROUTEA, TCBROUTEA;
+} PORTMUX_t;
+
+typedef struct {
+	volatile uint8_t CTRLA, CTRLB, EVCTRL, INTCTRL;
+	sim_flags_t INTFLAGS;
+	volatile uint8_t STATUS, DBGCTRL, TEMP;
+	volatile uint16_t CNT, CCMP;
+} TCB_t;
+
+typedef struct {
+	volatile uint8_t CTRLA, CTRLB, CTRLC, CTRLD, CTRLECLR, CTRLESET, CTRLFCLR, CTRLFSET;
+	volatile uint8_t EVCTRL, INTCTRL;
+	sim_flags_t INTFLAGS;
+	volatile uint8_t DBGCTRL, TEMP;
+	volatile uint16_t CNT, PER, CMP0, CMP1, CMP2;
+} TCA_SINGLE_t;
+
+typedef union {
+	TCA_SINGLE_t SINGLE;
+} TCA_t;
+
+typedef struct {
+	volatile uint8_t CTRLA, STATUS, INTCTRL;
+	sim_flags_t INTFLAGS;
+	volatile uint8_t TEMP, DBGCTRL, CALIB, CLKSEL;
+	volatile uint16_t CNT, PER, CMP;
+	volatile uint8_t PITCTRLA, PITSTATUS, PITINTCTRL;
+	sim_flags_t PITINTFLAGS;
+	volatile uint8_t PITDBGCTRL, PITEVGENCTRLA;
+} RTC_t;
+
+typedef struct {
+	volatile uint8_t MCLKCTRLA, MCLKCTRLB, MCLKCTRLC, MCLKINTCTRL, MCLKINTFLAGS, MCLKSTATUS, MCLKTIMEBASE;
+	volatile uint8_t OSCHFCTRLA, OSCHFTUNE;
+} CLKCTRL_t;
+
+typedef struct {
+	volatile uint8_t CTRLA, VREGCTRL;
+} SLPCTRL_t;
+
+extern VPORT_t sim_VPORTA, sim_VPORTB, sim_VPORTC, sim_VPORTD;
+extern PORT_t sim_PORTA, sim_PORTB;
+extern PORTMUX_t sim_PORTMUX;
+extern SPI_t sim_SPI0;
+extern USART_t sim_USART0;
+extern TCB_t sim_TCB0;
+extern TCA_t sim_TCA0;
+extern RTC_t sim_RTC;
+extern CLKCTRL_t sim_CLKCTRL;
+extern SLPCTRL_t sim_SLPCTRL;
+extern volatile uint8_t sim_SREG;
+
+void* sim_io(void* reg);
+
+#define VPORTA sim_VPORTA
+#define VPORTB sim_VPORTB
+#define VPORTC sim_VPORTC
+#define VPORTD sim_VPORTD
+#define PORTA (*(PORT_t*)sim_io(&sim_PORTA))
+#define PORTB (*(PORT_t*)sim_io(&sim_PORTB))
+#define PORTMUX (*(PORTMUX_t*)sim_io(&sim_PORTMUX))
+#define SPI0 (*(SPI_t*)sim_io(&sim_SPI0))
+#define USART0 (*(USART_t*)sim_io(&sim_USART0))
+#define TCB0 (*(TCB_t*)sim_io(&sim_TCB0))
+#define TCA0 (*(TCA_t*)sim_io(&sim_TCA0))
+#define RTC (*(RTC_t*)sim_io(&sim_RTC))
+#define CLKCTRL (*(CLKCTRL_t*)sim_io(&sim_CLKCTRL))
+#define SLPCTRL (*(SLPCTRL_t*)sim_io(&sim_SLPCTRL))
+#define SREG (*(volatile uint8_t*)sim_io((void*)&sim_SREG))
+
+#define _PROTECTED_WRITE(reg, value) ((reg) = (value))
+
+// Interrupt vectors, defined by the firmware with ISR()
+#define SPI0_INT_vect SPI0_INT_vect
+#define USART0_DRE_vect USART0_DRE_vect
+#define USART0_TXC_vect USART0_TXC_vect
+#define TCB0_INT_vect TCB0_INT_vect
+#define TCA0_OVF_vect TCA0_OVF_vect
+#define PORTB_PORT_vect PORTB_PORT_vect
+#define RTC_CNT_vect RTC_CNT_vect
+#define RTC_PIT_vect RTC_PIT_vect
+
+// Pins
+#define PIN0_bm 0x01
+#define PIN1_bm 0x02
+#define PIN2_bm 0x04
+#define PIN3_bm 0x08
+#define PIN4_bm 0x10
+#define PIN5_bm 0x20
+#define PIN6_bm 0x40
+#define PIN7_bm 0x80
+#define PORT_ISC_gm 0x07
+#define PORT_ISC_INTDISABLE_gc 0x00
+#define PORT_ISC_BOTHEDGES_gc 0x01
+#define PORT_ISC_RISING_gc 0x02
+#define PORT_ISC_FALLING_gc 0x03
+#define PORT_PULLUPEN_bm 0x08
+#define PORT_INVEN_bm 0x80
+
+// PORTMUX
+#define PORTMUX_USART0_gm 0x03
+#define PORTMUX_USART0_DEFAULT_gc 0x00
+#define PORTMUX_USART0_ALT1_gc 0x01
+
+// CPU
+#define CPU_I_bm 0x80
+
+// SPI
+#define SPI_ENABLE_bm 0x01
+#define SPI_PRESC_gm 0x06
+#define SPI_PRESC_DIV4_gc 0x00
+#define SPI_PRESC_DIV16_gc 0x02
+#define SPI_PRESC_DIV64_gc 0x04
+#define SPI_PRESC_DIV128_gc 0x06
+#define SPI_CLK2X_bm 0x10
+#define SPI_MASTER_bm 0x20
+#define SPI_DORD_bm 0x40
+#define SPI_MODE_gm 0x03
+#define SPI_MODE_3_gc 0x03
+#define SPI_SSD_bm 0x04
+#define SPI_BUFWR_bm 0x40
+#define SPI_BUFEN_bm 0x80
+#define SPI_IE_bm 0x01
+#define SPI_IF_bm 0x80
+
+// USART
+#define USART_DREIF_bm 0x20
+#define USART_TXCIF_bm 0x40
+#define USART_DREIE_bm 0x20
+#define USART_TXCIE_bm 0x40
+#define USART_TXEN_bm 0x40
+#define USART_CMODE_gm 0xC0
+#define USART_CMODE_MSPI_gc 0xC0
+#define USART_UDORD_bm 0x04
+#define USART_UCPHA_bm 0x02
+
+// TCB
+#define TCB_ENABLE_bm 0x01
+#define TCB_CLKSEL_gm 0x0E
+#define TCB_CLKSEL_DIV1_gc 0x00
+#define TCB_CLKSEL_DIV2_gc 0x02
+#define TCB_CNTMODE_gm 0x07
+#define TCB_CNTMODE_INT_gc 0x00
+#define TCB_CAPT_bm 0x01
+
+// TCA
+#define TCA_SINGLE_ENABLE_bm 0x01
+#define TCA_SINGLE_CLKSEL_gm 0x0E
+#define TCA_SINGLE_CLKSEL_DIV1_gc 0x00
+#define TCA_SINGLE_CLKSEL_DIV2_gc 0x02
+#define TCA_SINGLE_CLKSEL_DIV4_gc 0x04
+#define TCA_SINGLE_CLKSEL_DIV8_gc 0x06
+#define TCA_SINGLE_CLKSEL_DIV16_gc 0x08
+#define TCA_SINGLE_CLKSEL_DIV64_gc 0x0A
+#define TCA_SINGLE_CLKSEL_DIV256_gc 0x0C
+#define TCA_SINGLE_CLKSEL_DIV1024_gc 0x0E
+#define TCA_SINGLE_OVF_bm 0x01
+#define TCA_SINGLE_CMD_gm 0x0C
+#define TCA_SINGLE_CMD_RESTART_gc 0x08
+
+// RTC
+#define RTC_RTCEN_bm 0x01
+#define RTC_PRESCALER_gm 0x78
+#define RTC_PRESCALER_DIV1_gc 0x00
+#define RTC_PRESCALER_DIV32_gc 0x28
+#define RTC_RUNSTDBY_bm 0x80
+#define RTC_CLKSEL_gm 0x03
+#define RTC_CLKSEL_OSC32K_gc 0x00
+#define RTC_CLKSEL_OSC1K_gc 0x01
+#define RTC_OVF_bm 0x01
+#define RTC_CMP_bm 0x02
+#define RTC_CMPBUSY_bm 0x08
+#define RTC_PITEN_bm 0x01
+#define RTC_PI_bm 0x01
+
+// CLKCTRL
+#define CLKCTRL_FRQSEL_gm 0x3C
+#define CLKCTRL_FRQSEL_1M_gc 0x00
+#define CLKCTRL_FRQSEL_2M_gc 0x04
+#define CLKCTRL_FRQSEL_3M_gc 0x08
+#define CLKCTRL_FRQSEL_4M_gc 0x0C
+#define CLKCTRL_FRQSEL_8M_gc 0x14
+#define CLKCTRL_FRQSEL_12M_gc 0x18
+#define CLKCTRL_FRQSEL_16M_gc 0x1C
+#define CLKCTRL_FRQSEL_20M_gc 0x20
+#define CLKCTRL_FRQSEL_24M_gc 0x24
+#define CLKCTRL_AUTOTUNE_bm 0x01
+#define CLKCTRL_OSCHFS_bm 0x02
+
+// SLPCTRL
+#define SLPCTRL_SEN_bm 0x01
+#define SLPCTRL_SMODE_gm 0x06
+#define SLPCTRL_SMODE_IDLE_gc 0x00
+#define SLPCTRL_SMODE_STDBY_gc 0x02
+#define SLPCTRL_SMODE_PDOWN_gc 0x04
+
+#endif /* SIM_AVR_IO_H_ */
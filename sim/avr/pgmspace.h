@@ -0,0 +1,29 @@
+//***************************************************************************
+//
+// File Name : avr/pgmspace.h
+// Title : Simulator replacement for <avr/pgmspace.h>
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// On the host, flash and RAM share one address space, so PROGMEM data is read
+// with the ordinary functions.
+//
+//**************************************************************************
+
+#ifndef SIM_AVR_PGMSPACE_H_
+#define SIM_AVR_PGMSPACE_H_
+
+#include <string.h>
+#include <stdint.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+#endif /* SIM_AVR_PGMSPACE_H_ */
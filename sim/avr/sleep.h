@@ -0,0 +1,42 @@
+//***************************************************************************
+//
+// File Name : avr/sleep.h (simulator)
+// Title : Host sleep layer for the DOGM163 simulator
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// sleep_cpu() hands control to the simulator, which skips ahead to the next
+// peripheral event that runs an interrupt handler and counts the skipped time
+// as sleep.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : avr-libc <avr/sleep.h>
+//
+// Revision History : Initial version
+//
+//
+//**************************************************************************
+
+#ifndef SIM_AVR_SLEEP_H_
+#define SIM_AVR_SLEEP_H_
+
+#include <avr/io.h>
+
+void sim_sleep (void);
+
+#define SLEEP_MODE_IDLE SLPCTRL_SMODE_IDLE_gc
+#define SLEEP_MODE_STANDBY SLPCTRL_SMODE_STDBY_gc
+#define SLEEP_MODE_PWR_DOWN SLPCTRL_SMODE_PDOWN_gc
+
+#define set_sleep_mode(mode) (SLPCTRL.CTRLA = (SLPCTRL.CTRLA & ~SLPCTRL_SMODE_gm) | (mode))
+#define sleep_enable() (SLPCTRL.CTRLA |= SLPCTRL_SEN_bm)
+#define sleep_disable() (SLPCTRL.CTRLA &= ~SLPCTRL_SEN_bm)
+#define sleep_cpu() sim_sleep()
+#define sleep_mode() do { sleep_enable(); sleep_cpu(); sleep_disable(); } while (0)
+
+#endif /* SIM_AVR_SLEEP_H_ */
@@ -0,0 +1,427 @@
+//***************************************************************************
+//
+// File Name : bench.c
+// Title : Display refresh benchmark
+// Date : 10/16/2026
+// Version : 1.2
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This program times the display driver on the simulated DOGM163 chain. Each case
+// below starts from a freshly reset simulator, except where noted, and reports the
+// simulated time at the configured F_CPU and SPI clock, the bytes, commands and
+// data sent, the time spent in delays versus shifting bytes out, the fraction of the
+// time the CPU was awake (io_awake), and the wake ups and frames sent counted by the
+// main loop. The simulator only moves time on register accesses, delays and sleep, so
+// io_awake is the share of time the CPU spends awake on I/O and waits. The firmware's
+// computation is not charged, and io_awake can't show how much work a frame takes. That
+// work is counted instead: rows_laid is the canvas rows laid out by layout_next, and
+// rows_compared the canvas rows display_rows compared against the shadow. work_us is
+// what they would cost at SYSCLK_FAST_MHZ, at BENCH_LAYOUT_CYCLES for each column laid
+// out and BENCH_COMPARE_CYCLES for each column compared. These are estimates of the AVR
+// code, not measurements, so work_us only compares builds and cases with each other. The
+// bytes queued cost the same whichever way a frame is made, so they aren't in it:
+//
+// init_lcd_dog			Power up of every DOG LCD in 3 line mode
+// init_big_lcd_dog		Power up of every DOG LCD in the big font mode
+// boot					Reset until the first frame is on every DOG LCD
+// still_display_first	First frame after init_lcd_dog, until it is on the DOG LCDs
+// still_display_repeat	Same frame again, which should send nothing
+// down_scroll			One full down_scroll_display pass over the layout rows
+// idle					Main loop for BENCH_IDLE_S seconds after the scroll, which draws the
+//						still display once and then has nothing left to do
+// seek					Jump to the names, 4 rows up, jump to the special thanks and back to
+//						the message, the same as a person paging through them would
+// marquee				LCD_LINE_SIZE * MARQUEE_SPEED ms of the big font marquee, about one turn,
+//						from marquee_start to marquee_stop
+// glyph_marquee		MARQUEE_TEXT drawn 3 rows tall by glyph_show at every column from the
+//						right edge until it has left LCD0, back to back, starting with nothing
+//						in CGRAM. Each glyph upload is 1 to 3 commands and 8 data bytes
+// smooth_scroll		Every frame of a SCROLL_SMOOTH down scroll over the layout rows, drawn by
+//						glyph_slide_show one pixel line after another and each sent before the
+//						next. The longest frame gives smooth_tick_hz, the most ticks a second
+//						the bus keeps up with at the SPI clock in use
+// bus_stream			BENCH_STREAM_BYTES bytes queued back to back with no gap, to no DOG LCD,
+//						so they only load the bus. It gives bus_bytes_per_s, the most bytes a
+//						second the transmit path keeps up, which is the figure to set a
+//						LCD_USART=1 build against the SPI0 one
+//
+// The static RAM of the firmware (.data and .bss of its objects) and the peak stack
+// depth are reported as well. The stack is measured on the host, so it includes the
+// simulator's own frames and only shows trends, not the AVR figure.
+//
+// The results are written as JSON to the file named on the command line (bench.json
+// by default). With -c, a previous results file is read back and each case's time
+// and bytes are printed as a ratio to it. sim/bench_baseline.json holds the figures
+// the benchmark was introduced with, and is never written again. It and other files
+// from before version 1.1 call io_awake cpu_busy, which compare doesn't read. Build and
+// run from the repository root:
+//
+// gcc -Wall -Isim -I. -c DOGM163WA.c functions.c events.c sysclk.c layout.c glyph.c
+// ld -r -o firmware.o DOGM163WA.o functions.o events.o sysclk.o layout.o glyph.o
+// objcopy --rename-section .data=fw_data --rename-section .bss=fw_bss firmware.o
+// gcc -Wall -Isim -I. -o bench sim/bench.c sim/sim.c firmware.o
+// ./bench bench.json -c sim/bench_baseline.json
+//
+// For a wider wall, add -DLCD_PANELS=n to every gcc line above and generate
+// layout_rows.h with ./layout_gen n first. To time the USART0 backend, add -DLCD_USART=1
+// to every gcc line and compare with the results of the SPI0 build, for example
+// ./bench bench_usart.json -c bench.json
+// With -DSCROLL_SHOW=1 the down_scroll case plays the show stream, which should send the
+// same bytes as the frames it replaces with less work_us.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//					  1.1 - cpu_busy renamed io_awake, since computation isn't charged
+//					  1.2 - Rows laid out and compared, and the work_us they take
+//
+//**************************************************************************
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "sim.h"
+#include "DOGM163WA.h"
+#include "functions.h"
+#include "events.h"
+#include "glyph.h"
+#include "layout_rows.h"
+
+#define BENCH_CASES 13
+#define BENCH_LIMIT_PS (600000 * SIM_PS_PER_MS)	// Longest a case may run
+#define BENCH_IDLE_S 10							// Length of the idle case
+#define BENCH_STREAM_BYTES 4096					// Bytes sent by the bus_stream case
+#define BENCH_NO_LCD 0xFF						// Same as LCD_NONE in DOGM163WA.c, no /SS line goes low
+#define BENCH_COLS (LCD_PANELS * LCD_COLS)		// Columns of a canvas row, CANVAS_COLS in functions.c
+#define BENCH_LAYOUT_CYCLES 30					// CPU cycles to lay out one column of a row, an estimate
+#define BENCH_COMPARE_CYCLES 12					// CPU cycles to compare one column of a row, an estimate
+
+// Firmware RAM, from the sections the objcopy step renames
+extern char __start_fw_data[] __attribute__((weak)), __stop_fw_data[] __attribute__((weak));
+extern char __start_fw_bss[] __attribute__((weak)), __stop_fw_bss[] __attribute__((weak));
+
+typedef struct {
+	const char* name;
+	uint64_t time_ps;
+	sim_stats_t stats;
+	loop_stats_t loop;
+	unsigned long overruns;
+} bench_case_t;
+
+static bench_case_t cases[BENCH_CASES];
+static uint8_t case_count;
+static uintptr_t stack_peak;
+static double spi_hz;						// SCK while frames are sent
+static uint64_t slide_worst_ps;				// Longest frame of the smooth scroll
+static uint64_t stream_ps;					// Time the bus stream took
+
+static void (*case_fn)(void);
+
+static void run_case_fn (void) {
+	sim_stack_base();
+	case_fn();
+}
+
+//***************************************************************************
+//
+// Function Name : static void run_case (const char* name, void (*fn)(void))
+//
+// This function runs fn on the simulator and records the time and statistics it
+// took. The DOG LCD state carries over from the case before, so cases that need
+// initialized DOG LCDs run right after an init case.
+//
+//**************************************************************************
+
+static void run_case (const char* name, void (*fn)(void)) {
+	bench_case_t* c = &cases[case_count++];
+	uint64_t start = sim_now_ps;
+
+	sim_stats_reset();
+	memset(&loop_stats, 0, sizeof(loop_stats));
+	case_fn = fn;
+	if (sim_run(run_case_fn, BENCH_LIMIT_PS))
+		fprintf(stderr, "bench: %s hit the time limit\n", name);
+
+	c->name = name;
+	c->time_ps = sim_now_ps - start;
+	c->stats = sim_stats;
+	c->loop = loop_stats;
+	for (uint8_t i = 0; i < SIM_PANELS; i++)
+		c->overruns += sim_lcd[i].overruns;
+	if (sim_stats.stack_peak > stack_peak)
+		stack_peak = sim_stats.stack_peak;
+}
+
+static void bench_reset (void) {
+	sim_reset();
+	sysclk_set(SYSCLK_BOOT_MHZ);			// The firmware's copy of the clock follows the reset too
+}
+
+static void bench_init (void) {
+	init_lcd_dog();
+}
+
+static void bench_init_big (void) {
+	init_big_lcd_dog();
+}
+
+static void bench_still (void) {
+	sei();
+	display_clock(SYSCLK_FAST_MHZ);			// Same clock as main builds frames at
+	spi_hz = sim_spi_hz();
+	still_display();
+	lcd_spi_flush();
+	cli();
+}
+
+static void bench_boot (void) {
+	init_lcd_dog();
+	bench_still();
+}
+
+static void bench_scroll (void) {
+	init_events();							// The RTC times the scroll
+	set_sleep_mode(SLEEP_MODE_IDLE);
+	sei();
+	display_clock(SYSCLK_FAST_MHZ);
+	down_scroll_display();
+	while (scroll_service()) {				// Same service, clock and sleep loop as main
+		idle_sleep();
+		if (scroll_pending())
+			display_clock(SYSCLK_FAST_MHZ);
+	}
+	lcd_spi_flush();
+	cli();
+}
+
+static void bench_marquee (void) {
+	uint32_t end;
+
+	sei();
+	display_clock(SYSCLK_FAST_MHZ);
+	marquee_start();
+	end = clock_ticks() + (uint32_t)LCD_LINE_SIZE * MARQUEE_SPEED * CLOCK_HZ / 1000;
+	while ((int32_t)(clock_ticks() - end) < 0) {	// Same loop as main
+		if (event_pending() || scroll_pending())
+			display_clock(SYSCLK_FAST_MHZ);
+		display_service();
+		idle_sleep();
+	}
+	marquee_service();						// Steps of the last tick
+	marquee_stop();
+	lcd_spi_flush();
+	cli();
+}
+
+static void bench_glyphs (void) {
+	sei();
+	display_clock(SYSCLK_FAST_MHZ);
+	glyph_reset();
+	for (int16_t x = LCD_PANELS * LCD_COLS; x >= -GLYPH_TEXT_COLS((int16_t)sizeof(MARQUEE_TEXT) - 1); x--)
+		glyph_show(MARQUEE_TEXT, x, 3);
+	lcd_spi_flush();
+	cli();
+}
+
+static void bench_slide (void) {
+	const char* rows[4];
+
+	sei();
+	display_clock(SYSCLK_FAST_MHZ);
+	for (uint16_t top = 0; top + 1 < LAYOUT_ROWS; top++)
+		for (uint8_t line = 0; line < GLYPH_ROWS; line++) {
+			uint64_t start = sim_now_ps;
+			for (uint8_t j = 0; j < 4; j++)
+				rows[j] = layout_rows[top + j];
+			glyph_slide_show(rows, line);
+			lcd_spi_flush();
+			if (sim_now_ps - start > slide_worst_ps)
+				slide_worst_ps = sim_now_ps - start;
+		}
+	cli();
+}
+
+static void bench_stream (void) {
+	sei();
+	display_clock(SYSCLK_FAST_MHZ);
+	uint64_t start = sim_now_ps;
+	for (uint16_t i = 0; i < BENCH_STREAM_BYTES; i++)
+		lcd_spi_enqueue(BENCH_NO_LCD, 1, (uint8_t)i, LCD_GAP_NONE);
+	lcd_spi_flush();
+	stream_ps = sim_now_ps - start;
+	cli();
+}
+
+static void bench_seek (void) {
+	sei();
+	display_clock(SYSCLK_FAST_MHZ);
+	scroll_jump(LAYOUT_SECTION_NAMES);
+	for (uint8_t i = 0; i < 4; i++)
+		scroll_up();
+	scroll_jump(LAYOUT_SECTION_THANKS);
+	scroll_jump(LAYOUT_SECTION_MESSAGE);
+	scroll_stop();
+	lcd_spi_flush();
+	cli();
+}
+
+static void bench_idle (void) {
+	uint32_t end = clock_ticks() + BENCH_IDLE_S * CLOCK_HZ;
+
+	sei();
+	while ((int32_t)(clock_ticks() - end) < 0) {	// Main loop with nothing to do
+		dispatch_events();
+		display_service();
+		idle_sleep();
+	}
+	cli();
+}
+
+//***************************************************************************
+//
+// Function Name : static double case_work_us (const bench_case_t* c)
+//
+// This function returns the time the rows laid out and compared in case c would take
+// the CPU at SYSCLK_FAST_MHZ, from the cycle estimates at the top of this file.
+//
+//**************************************************************************
+
+static double case_work_us (const bench_case_t* c) {
+	return ((double)c->loop.rows_laid * BENCH_LAYOUT_CYCLES + (double)c->loop.rows_compared * BENCH_COMPARE_CYCLES)
+		* BENCH_COLS / SYSCLK_FAST_MHZ;
+}
+
+//***************************************************************************
+//
+// Function Name : static void write_results (FILE* out)
+//
+// This function writes the results as JSON, one case per line so the file can also
+// be read back by compare and diffed by hand.
+//
+//**************************************************************************
+
+static void write_results (FILE* out) {
+	fprintf(out, "{\n");
+	fprintf(out, "  \"lcd_panels\": %d,\n", LCD_PANELS);
+	fprintf(out, "  \"lcd_usart\": %d,\n", LCD_USART);
+	fprintf(out, "  \"f_cpu_hz\": %lu,\n", (unsigned long)F_CPU);
+	fprintf(out, "  \"fast_cpu_hz\": %lu,\n", SYSCLK_FAST_MHZ * 1000000UL);
+	fprintf(out, "  \"idle_cpu_hz\": %lu,\n", SYSCLK_IDLE_MHZ * 1000000UL);
+	fprintf(out, "  \"spi_hz\": %.0f,\n", spi_hz);
+	fprintf(out, "  \"ram_data_bytes\": %ld,\n", (long)(__stop_fw_data - __start_fw_data));
+	fprintf(out, "  \"ram_bss_bytes\": %ld,\n", (long)(__stop_fw_bss - __start_fw_bss));
+	fprintf(out, "  \"host_stack_peak_bytes\": %lu,\n", (unsigned long)stack_peak);
+	fprintf(out, "  \"smooth_tick_hz\": %.1f,\n", slide_worst_ps ? 1e12 / slide_worst_ps : 0);
+	fprintf(out, "  \"bus_bytes_per_s\": %.0f,\n", stream_ps ? BENCH_STREAM_BYTES * 1e12 / stream_ps : 0);
+	fprintf(out, "  \"cases\": {\n");
+	for (uint8_t i = 0; i < case_count; i++) {
+		bench_case_t* c = &cases[i];
+		double awake = c->time_ps ? 1.0 - (double)c->stats.sleep_ps / c->time_ps : 0;
+		fprintf(out, "    \"%s\": { \"time_us\": %.3f, \"bytes\": %lu, \"commands\": %lu, \"data\": %lu, "
+			"\"bus_us\": %.3f, \"delay_us\": %.3f, \"sleep_us\": %.3f, \"standby_us\": %.3f, \"io_awake\": %.6f, "
+			"\"interrupts\": %lu, \"clock_changes\": %lu, \"wakeups\": %lu, \"frames\": %lu, "
+			"\"rows_laid\": %lu, \"rows_compared\": %lu, \"work_us\": %.3f, \"overruns\": %lu }%s\n",
+			c->name, c->time_ps / 1e6, c->stats.bytes, c->stats.commands, c->stats.data,
+			c->stats.bus_ps / 1e6, c->stats.delay_ps / 1e6, c->stats.sleep_ps / 1e6, c->stats.standby_ps / 1e6, awake,
+			c->stats.interrupts, c->stats.clock_changes, (unsigned long)c->loop.wakeups, (unsigned long)c->loop.frames,
+			(unsigned long)c->loop.rows_laid, (unsigned long)c->loop.rows_compared, case_work_us(c),
+			c->overruns, i + 1 < case_count ? "," : "");
+	}
+	fprintf(out, "  }\n}\n");
+}
+
+//***************************************************************************
+//
+// Function Name : static void compare (const char* path)
+//
+// This function reads a results file written by write_results and prints the time,
+// bytes and work_us of each case as a ratio to it. Files from before work_us was
+// reported show no work ratio.
+//
+//**************************************************************************
+
+static void compare (const char* path) {
+	FILE* in = fopen(path, "r");
+	char line[512];
+
+	if (!in) {
+		fprintf(stderr, "bench: can't read %s\n", path);
+		return;
+	}
+	printf("\ncompared to %s:\n", path);
+	while (fgets(line, sizeof(line), in)) {
+		char name[64];
+		double time_us, work_us;
+		unsigned long bytes;
+		char* p = strstr(line, "\"time_us\":");
+		char* q = strstr(line, "\"bytes\":");
+		char* w = strstr(line, "\"work_us\":");
+		if (!p || !q || sscanf(line, " \"%63[^\"]\"", name) != 1)
+			continue;
+		time_us = atof(p + 10);
+		bytes = strtoul(q + 8, NULL, 10);
+		work_us = w ? atof(w + 10) : 0;
+		for (uint8_t i = 0; i < case_count; i++) {
+			if (strcmp(cases[i].name, name))
+				continue;
+			printf("  %-22s time %7.3fx  bytes %7.3fx", name,
+				time_us ? cases[i].time_ps / 1e6 / time_us : 0,
+				bytes ? (double)cases[i].stats.bytes / bytes : 0);
+			if (work_us)
+				printf("  work %7.3fx", case_work_us(&cases[i]) / work_us);
+			printf("\n");
+		}
+	}
+	fclose(in);
+}
+
+int main (int argc, char** argv) {
+	const char* path = "bench.json";
+	const char* baseline = NULL;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-c") && i + 1 < argc)
+			baseline = argv[++i];
+		else
+			path = argv[i];
+	}
+
+	bench_reset();
+	run_case("init_lcd_dog", bench_init);
+	run_case("still_display_first", bench_still);
+	run_case("still_display_repeat", bench_still);
+	run_case("down_scroll", bench_scroll);
+	run_case("idle", bench_idle);
+	run_case("seek", bench_seek);
+	run_case("marquee", bench_marquee);
+	run_case("glyph_marquee", bench_glyphs);
+	run_case("smooth_scroll", bench_slide);
+	run_case("bus_stream", bench_stream);
+
+	bench_reset();
+	run_case("init_big_lcd_dog", bench_init_big);
+
+	bench_reset();
+	run_case("boot", bench_boot);
+
+	FILE* out = fopen(path, "w");
+	if (!out) {
+		fprintf(stderr, "bench: can't write %s\n", path);
+		return 1;
+	}
+	write_results(out);
+	fclose(out);
+	write_results(stdout);
+
+	if (baseline)
+		compare(baseline);
+	return 0;
+}
@@ -0,0 +1,870 @@
+//***************************************************************************
+//
+// File Name : sim.c
+// Title : DOGM163 / ST7036 controller simulator
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This file backs the replacement AVR headers with a simulated AVR128DB48 bus
+// and a chain of SIM_PANELS DOGM163 displays. Simulated time only moves when the firmware
+// touches a register, waits in a delay or sleeps. Each register access costs
+// SIM_IO_CYCLES CPU cycles, which is enough for polling loops to make progress.
+//
+// The SPI transfer time comes from the SPI0 prescaler, CLK2X and the CPU clock
+// selected in CLKCTRL. USART0 in master SPI mode is modelled as well, with its
+// BAUD divider and a transmit buffer that holds one byte while another is shifted
+// out, so back to back bytes follow each other with no break. When a transfer ends
+// the byte is handed to every DOG LCD whose /SS line is low, with RS read from its
+// own PORTC pin. Each ST7036
+// model decodes the instruction, updates its DDRAM, CGRAM and settings, and
+// records a byte that arrives before the last instruction finished executing
+// as an overrun.
+//
+// Warnings : Timing of the firmware's own code is only approximated by the
+//			  fixed cost per register access. Computation between register accesses
+//			  takes no simulated time, so the time the CPU is awake only covers its
+//			  I/O, delays and waits
+// Restrictions : none
+// Algorithms : none
+// References : ST7036 datasheet, instruction table and execution times
+//
+// Revision History : Initial version
+//
+//
+//**************************************************************************
+
+#include <setjmp.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <avr/io.h>
+#include "sim.h"
+
+#define SIM_IO_CYCLES 2						// CPU cycles charged for each register access
+#define SIM_SPI_EMPTY 0x100					// SPI0.DATA value meaning nothing was written
+
+// ST7036 execution times at the nominal 380kHz oscillator
+#define SIM_EXEC_PS (263 * SIM_PS_PER_US / 10)
+#define SIM_EXEC_CLEAR_PS (1080 * SIM_PS_PER_US)
+#define SIM_EXEC_FOLLOWER_PS (200 * SIM_PS_PER_MS)
+
+VPORT_t sim_VPORTA, sim_VPORTB, sim_VPORTC, sim_VPORTD;
+
+typedef struct {
+	VPORT_t* ss;							// Port and pin of the /SS line
+	uint8_t ss_bm;
+	uint8_t rs_bm;							// Pin of the RS line on PORTC
+} sim_wire_t;
+
+// Wiring of the DOG LCDs on the board, LCD0 first
+static const sim_wire_t sim_wires[8] = {
+	{ &sim_VPORTB, PIN0_bm, PIN0_bm },
+	{ &sim_VPORTB, PIN1_bm, PIN1_bm },
+	{ &sim_VPORTB, PIN3_bm, PIN2_bm },
+	{ &sim_VPORTB, PIN4_bm, PIN3_bm },
+	{ &sim_VPORTB, PIN5_bm, PIN4_bm },
+	{ &sim_VPORTD, PIN0_bm, PIN5_bm },
+	{ &sim_VPORTD, PIN1_bm, PIN6_bm },
+	{ &sim_VPORTD, PIN2_bm, PIN7_bm }
+};
+
+_Static_assert(SIM_PANELS >= 1 && SIM_PANELS <= 8, "the board has room for 1 to 8 DOG LCDs");
+PORT_t sim_PORTA, sim_PORTB;
+PORTMUX_t sim_PORTMUX;
+SPI_t sim_SPI0;
+USART_t sim_USART0;
+TCB_t sim_TCB0;
+TCA_t sim_TCA0;
+RTC_t sim_RTC;
+CLKCTRL_t sim_CLKCTRL;
+SLPCTRL_t sim_SLPCTRL;
+volatile uint8_t sim_SREG;
+
+sim_lcd_t sim_lcd[SIM_PANELS];
+sim_stats_t sim_stats;
+uint64_t sim_now_ps;
+FILE* sim_trace;
+
+// Interrupt handlers the firmware may define with ISR()
+extern void SPI0_INT_vect (void) __attribute__((weak));
+extern void USART0_DRE_vect (void) __attribute__((weak));
+extern void USART0_TXC_vect (void) __attribute__((weak));
+extern void TCB0_INT_vect (void) __attribute__((weak));
+extern void TCA0_OVF_vect (void) __attribute__((weak));
+extern void PORTB_PORT_vect (void) __attribute__((weak));
+extern void RTC_CNT_vect (void) __attribute__((weak));
+
+// Interrupt flag registers, see sim_flags_t
+enum { F_PORTB, F_SPI0, F_USART0, F_TCB0, F_TCA0, F_RTC, F_PIT, F_COUNT };
+#define SIM_FLAG_MARK 0xA500
+static uint8_t flags[F_COUNT];
+
+static sim_flags_t* flag_reg (uint8_t f) {
+	switch (f) {
+		case F_PORTB: return &sim_PORTB.INTFLAGS;
+		case F_SPI0: return &sim_SPI0.INTFLAGS;
+		case F_USART0: return &sim_USART0.STATUS;
+		case F_TCB0: return &sim_TCB0.INTFLAGS;
+		case F_TCA0: return &sim_TCA0.SINGLE.INTFLAGS;
+		case F_RTC: return &sim_RTC.INTFLAGS;
+		default: return &sim_RTC.PITINTFLAGS;
+	}
+}
+
+static void flag_set (uint8_t f, uint8_t bm) { flags[f] |= bm; *flag_reg(f) = SIM_FLAG_MARK | flags[f]; }
+static void flag_clr (uint8_t f, uint8_t bm) { flags[f] &= ~bm; *flag_reg(f) = SIM_FLAG_MARK | flags[f]; }
+
+static void flags_sync (void) {							// Applies flag clears written by the firmware
+	for (uint8_t f = 0; f < F_COUNT; f++) {
+		sim_flags_t* reg = flag_reg(f);
+		if ((*reg & 0xFF00) != SIM_FLAG_MARK)
+			flag_clr(f, *reg & 0xFF);
+	}
+}
+
+static uint64_t spi_done_ps;				// End of the transfer in flight, 0 when idle
+static uint8_t spi_byte;
+static uint64_t usart_done_ps;				// End of the byte in the USART0 shift register, 0 when idle
+static uint8_t usart_byte;
+static uint16_t usart_buf;					// Byte in the USART0 transmit buffer, SIM_SPI_EMPTY when empty
+static uint64_t tcb_next_ps;				// Next TCB0 capture, 0 when stopped
+static uint64_t tca_next_ps;				// Next TCA0 overflow, 0 when stopped
+static uint64_t button_down_ps, button_up_ps;	// Edges of the press in progress, 0 when done
+static uint64_t press_at[SIM_PRESSES], press_hold[SIM_PRESSES];
+static uint8_t press_next, press_count;
+static uint8_t rtc_on;
+static uint64_t rtc_start_ps;				// Time the RTC was enabled
+static uint64_t rtc_next_ps;				// Next RTC overflow
+static uint64_t rtc_cmp_ps;					// Next RTC compare match
+static uint16_t rtc_cmp;					// RTC.CMP that rtc_cmp_ps was found for
+static uint8_t clock_sel;					// OSCHFCTRLA seen by the last sim_poll
+static uint8_t in_isr;
+static uint8_t in_sim;
+
+static jmp_buf run_jmp;
+static uint8_t running;
+static uint64_t run_limit_ps;
+static uintptr_t stack_base;
+
+//***************************************************************************
+//
+// Function Name : double sim_cpu_hz (void) & double sim_spi_hz (void)
+//
+// These functions return the CPU clock selected in CLKCTRL.OSCHFCTRLA and the
+// SPI clock. That is the USART0 clock from its BAUD divider when its transmitter is
+// on, and otherwise the SPI0 clock that follows from the prescaler and CLK2X bits.
+//
+//**************************************************************************
+
+double sim_cpu_hz (void) {
+	static const uint8_t mhz[16] = { 1, 2, 3, 4, 4, 8, 12, 16, 20, 24, 4, 4, 4, 4, 4, 4 };
+	return mhz[(sim_CLKCTRL.OSCHFCTRLA & CLKCTRL_FRQSEL_gm) >> 2] * 1e6;
+}
+
+double sim_spi_hz (void) {
+	static const uint8_t div[4] = { 4, 16, 64, 128 };
+	if (sim_USART0.CTRLB & USART_TXEN_bm) {
+		uint16_t baud = sim_USART0.BAUD >> 6;	// Master SPI mode uses only the integer part
+		return sim_cpu_hz() / (2.0 * (baud ? baud : 1));
+	}
+	double hz = sim_cpu_hz() / div[(sim_SPI0.CTRLA & SPI_PRESC_gm) >> 1];
+	return (sim_SPI0.CTRLA & SPI_CLK2X_bm) ? hz * 2 : hz;
+}
+
+static uint64_t cycles_ps (double cycles) {
+	return (uint64_t)(cycles * 1e12 / sim_cpu_hz() + 0.5);
+}
+
+//***************************************************************************
+//
+// Function Name : static void lcd_receive (sim_lcd_t* lcd, uint8_t rs, uint8_t byte)
+//
+// This function decodes one serial byte received by an ST7036. Data bytes are
+// written to DDRAM or CGRAM at the address counter. Commands are decoded with the
+// instruction table selected by the IS bits of the last function set.
+//
+//**************************************************************************
+
+static uint8_t lcd_ac_step (sim_lcd_t* lcd, uint8_t ac) {
+	if (lcd->entry & 0x02) {
+		ac++;
+		if (ac >= 0x50)
+			ac = 0x00;
+	}
+	else
+		ac = ac ? ac - 1 : 0x4F;
+	return ac;
+}
+
+static void lcd_receive (sim_lcd_t* lcd, uint8_t rs, uint8_t byte) {
+	uint64_t exec = SIM_EXEC_PS;
+
+	if (sim_now_ps < lcd->busy_until)
+		lcd->overruns++;
+	lcd->bytes++;
+
+	if (rs) {
+		lcd->data++;
+		if (lcd->cgram_mode) {
+			lcd->cgram[lcd->ac & 0x3F] = byte & 0x1F;
+			lcd->ac = (lcd->ac + 1) & 0x3F;
+		}
+		else {
+			lcd->ddram[lcd->ac & 0x7F] = byte;
+			lcd->ac = lcd_ac_step(lcd, lcd->ac);
+		}
+		lcd->busy_until = sim_now_ps + exec;
+		return;
+	}
+
+	lcd->commands++;
+	uint8_t is = lcd->function & 0x03;
+
+	if (byte & 0x80) {							// Set DDRAM address
+		lcd->ac = byte & 0x7F;
+		lcd->cgram_mode = 0;
+	}
+	else if (byte & 0x40) {
+		if (is == 0) {							// Set CGRAM address
+			lcd->ac = byte & 0x3F;
+			lcd->cgram_mode = 1;
+		}
+		else if (is == 1) {
+			if ((byte & 0x70) == 0x50)			// Power/icon control/contrast set
+				lcd->power = byte & 0x0F;
+			else if ((byte & 0x70) == 0x60) {	// Follower control
+				lcd->follower = byte & 0x0F;
+				exec = SIM_EXEC_FOLLOWER_PS;
+			}
+			else if ((byte & 0x70) == 0x70)		// Contrast set
+				lcd->contrast = byte & 0x0F;
+		}
+	}
+	else if (byte & 0x20)						// Function set
+		lcd->function = byte & 0x1F;
+	else if (byte & 0x10) {
+		if (is == 0) {							// Cursor or display shift
+			if (byte & 0x08)
+				lcd->shift = (lcd->shift + ((byte & 0x04) ? -1 : 1)) % 80;
+			else
+				lcd->ac = lcd_ac_step(lcd, lcd->ac);
+		}
+		else if (is == 1)						// Bias set
+			lcd->bias = byte & 0x09;
+	}
+	else if (byte & 0x08)						// Display on/off control
+		lcd->display = byte & 0x07;
+	else if (byte & 0x04)						// Entry mode set
+		lcd->entry = byte & 0x03;
+	else if (byte & 0x02) {						// Return home
+		lcd->ac = 0;
+		lcd->shift = 0;
+		lcd->cgram_mode = 0;
+		exec = SIM_EXEC_CLEAR_PS;
+	}
+	else if (byte & 0x01) {						// Clear display
+		memset(lcd->ddram, ' ', sizeof(lcd->ddram));
+		lcd->ac = 0;
+		lcd->shift = 0;
+		lcd->cgram_mode = 0;
+		lcd->entry |= 0x02;
+		exec = SIM_EXEC_CLEAR_PS;
+	}
+
+	lcd->busy_until = sim_now_ps + exec;
+}
+
+//***************************************************************************
+//
+// Function Name : static void bus_deliver (uint8_t byte) & static void spi_complete (void) &
+//				   static void usart_complete (void)
+//
+// bus_deliver hands a byte that has been shifted out to every DOG LCD whose /SS line
+// in sim_wires is low, with RS taken from its PORTC pin. spi_complete ends the SPI0
+// transfer in flight. usart_complete ends the USART0 one and moves the byte waiting
+// in its transmit buffer, if any, into the shift register. A USART0 byte only reaches
+// the DOG LCDs if USART0 is in master SPI mode on PA4 and PA6, with SPI mode 3.
+//
+//**************************************************************************
+
+static void bus_deliver (uint8_t byte) {
+	uint8_t delivered = 0, data = 0;
+
+	for (uint8_t i = 0; i < SIM_PANELS; i++) {
+		const sim_wire_t* w = &sim_wires[i];
+		if (!(w->ss->DIR & w->ss_bm) || (w->ss->OUT & w->ss_bm))
+			continue;
+		uint8_t rs = (sim_VPORTC.OUT & w->rs_bm) != 0;
+		lcd_receive(&sim_lcd[i], rs, byte);
+		if (sim_trace)
+			fprintf(sim_trace, "%12.3fus LCD%u %s 0x%02X\n", sim_now_ps / 1e6, i,
+				rs ? "DATA" : "CMD ", byte);
+		delivered = 1;
+		data |= rs;
+	}
+
+	if (!delivered) {
+		sim_stats.lost++;
+		return;
+	}
+	sim_stats.bytes++;
+	if (data)
+		sim_stats.data++;
+	else
+		sim_stats.commands++;
+}
+
+static void spi_complete (void) {
+	spi_done_ps = 0;
+	flag_set(F_SPI0, SPI_IF_bm);
+	bus_deliver(spi_byte);
+}
+
+static void usart_start (void) {						// Moves the buffered byte into the shift register
+	uint64_t wire = (uint64_t)(8e12 / sim_spi_hz() + 0.5);
+	usart_byte = (uint8_t)usart_buf;
+	usart_buf = SIM_SPI_EMPTY;
+	usart_done_ps = sim_now_ps + wire;
+	sim_stats.bus_ps += wire;
+	flag_set(F_USART0, USART_DREIF_bm);
+}
+
+static void usart_complete (void) {
+	uint8_t byte = usart_byte;
+	uint8_t wired = (sim_USART0.CTRLC & USART_CMODE_gm) == USART_CMODE_MSPI_gc
+		&& (sim_USART0.CTRLC & USART_UCPHA_bm) && !(sim_USART0.CTRLC & USART_UDORD_bm)
+		&& (sim_PORTMUX.USARTROUTEA & PORTMUX_USART0_gm) == PORTMUX_USART0_ALT1_gc
+		&& (sim_PORTA.PIN6CTRL & PORT_INVEN_bm);
+
+	if (usart_buf != SIM_SPI_EMPTY)
+		usart_start();
+	else {
+		usart_done_ps = 0;
+		flag_set(F_USART0, USART_TXCIF_bm);
+	}
+	if (wired)
+		bus_deliver(byte);
+	else
+		sim_stats.lost++;
+}
+
+static double rtc_tick_ps (void) {
+	double hz = (sim_RTC.CLKSEL & RTC_CLKSEL_gm) == RTC_CLKSEL_OSC1K_gc ? 1024.0 : 32768.0;
+	return 1e12 / hz * (1 << ((sim_RTC.CTRLA & RTC_PRESCALER_gm) >> 3));
+}
+
+static uint64_t rtc_period_ps (void) {
+	return (uint64_t)(rtc_tick_ps() * ((uint32_t)sim_RTC.PER + 1) + 0.5);
+}
+
+static void rtc_sync (void) {							// Brings RTC.CNT up to the current time
+	if (rtc_on)
+		sim_RTC.CNT = (uint16_t)((uint64_t)((sim_now_ps - rtc_start_ps) / rtc_tick_ps()) % ((uint32_t)sim_RTC.PER + 1));
+}
+
+static uint64_t rtc_cmp_next (void) {					// Next time RTC.CNT steps onto RTC.CMP
+	double tick = rtc_tick_ps();
+	uint32_t top = (uint32_t)sim_RTC.PER + 1;
+	uint64_t now = (uint64_t)((sim_now_ps - rtc_start_ps) / tick);
+	uint64_t k = now - now % top + sim_RTC.CMP % top;
+	while (rtc_start_ps + (uint64_t)(k * tick + 0.5) <= sim_now_ps)
+		k += top;
+	rtc_cmp = sim_RTC.CMP;
+	return rtc_start_ps + (uint64_t)(k * tick + 0.5);
+}
+
+static uint64_t tca_period_ps (void) {
+	static const uint16_t div[8] = { 1, 2, 4, 8, 16, 64, 256, 1024 };
+	uint16_t d = div[(sim_TCA0.SINGLE.CTRLA & TCA_SINGLE_CLKSEL_gm) >> 1];
+	return cycles_ps((double)(sim_TCA0.SINGLE.PER + 1) * d);
+}
+
+//***************************************************************************
+//
+// Function Name : static void sim_poll (void)
+//
+// This function picks up register writes made since the last access: a new byte
+// in SPI0.DATA starts a transfer, a new byte in USART0.TXDATAL goes into the
+// transmit buffer and on to the shift register if that is idle, and TCB0 starts or
+// stops when its ENABLE bit changes.
+//
+//**************************************************************************
+
+static void sim_poll (void) {
+	flags_sync();
+
+	if (sim_CLKCTRL.OSCHFCTRLA != clock_sel) {
+		clock_sel = sim_CLKCTRL.OSCHFCTRLA;
+		sim_stats.clock_changes++;
+	}
+
+	if (sim_SPI0.DATA != SIM_SPI_EMPTY) {
+		if ((sim_SPI0.CTRLA & (SPI_ENABLE_bm | SPI_MASTER_bm)) == (SPI_ENABLE_bm | SPI_MASTER_bm)) {
+			if (spi_done_ps)
+				sim_stats.collisions++;
+			spi_byte = (uint8_t)sim_SPI0.DATA;
+			uint64_t wire = (uint64_t)(8e12 / sim_spi_hz() + 0.5);
+			spi_done_ps = sim_now_ps + wire;
+			sim_stats.bus_ps += wire;
+			flag_clr(F_SPI0, SPI_IF_bm);
+		}
+		sim_SPI0.DATA = SIM_SPI_EMPTY;
+	}
+
+	if (sim_USART0.TXDATAL != SIM_SPI_EMPTY) {
+		if (sim_USART0.CTRLB & USART_TXEN_bm) {
+			if (usart_buf != SIM_SPI_EMPTY)
+				sim_stats.collisions++;
+			usart_buf = (uint8_t)sim_USART0.TXDATAL;
+			flag_clr(F_USART0, USART_DREIF_bm);
+			if (!usart_done_ps)
+				usart_start();
+		}
+		sim_USART0.TXDATAL = SIM_SPI_EMPTY;
+	}
+
+	if ((sim_TCB0.CTRLA & TCB_ENABLE_bm) && !tcb_next_ps) {
+		uint8_t div = (sim_TCB0.CTRLA & TCB_CLKSEL_gm) == TCB_CLKSEL_DIV2_gc ? 2 : 1;
+		tcb_next_ps = sim_now_ps + cycles_ps((double)(sim_TCB0.CCMP + 1) * div);
+	}
+	else if (!(sim_TCB0.CTRLA & TCB_ENABLE_bm))
+		tcb_next_ps = 0;
+
+	if ((sim_TCA0.SINGLE.CTRLA & TCA_SINGLE_ENABLE_bm) && !tca_next_ps)
+		tca_next_ps = sim_now_ps + tca_period_ps();
+	else if (!(sim_TCA0.SINGLE.CTRLA & TCA_SINGLE_ENABLE_bm))
+		tca_next_ps = 0;
+
+	if ((sim_RTC.CTRLA & RTC_RTCEN_bm) && !rtc_on) {
+		rtc_on = 1;
+		rtc_start_ps = sim_now_ps;
+		rtc_next_ps = sim_now_ps + rtc_period_ps();
+		rtc_cmp_ps = rtc_cmp_next();
+	}
+	else if (!(sim_RTC.CTRLA & RTC_RTCEN_bm))
+		rtc_on = 0;
+	else if (sim_RTC.CMP != rtc_cmp)
+		rtc_cmp_ps = rtc_cmp_next();
+	rtc_sync();
+}
+
+//***************************************************************************
+//
+// Function Name : static uint64_t next_event (void) & static void fire_events (void)
+//
+// These functions find the time of the next peripheral event, and apply every
+// event that is due at the current time.
+//
+//**************************************************************************
+
+static uint64_t next_event (void) {
+	uint64_t next = UINT64_MAX;
+	if (spi_done_ps && spi_done_ps < next) next = spi_done_ps;
+	if (usart_done_ps && usart_done_ps < next) next = usart_done_ps;
+	if (tcb_next_ps && tcb_next_ps < next) next = tcb_next_ps;
+	if (tca_next_ps && tca_next_ps < next) next = tca_next_ps;
+	if (rtc_on && rtc_next_ps < next) next = rtc_next_ps;
+	if (rtc_on && rtc_cmp_ps < next) next = rtc_cmp_ps;
+	if (button_down_ps && button_down_ps < next) next = button_down_ps;
+	if (button_up_ps && button_up_ps < next) next = button_up_ps;
+	return next;
+}
+
+static void fire_events (void) {
+	if (spi_done_ps && spi_done_ps <= sim_now_ps)
+		spi_complete();
+
+	if (usart_done_ps && usart_done_ps <= sim_now_ps)
+		usart_complete();
+
+	if (tcb_next_ps && tcb_next_ps <= sim_now_ps) {
+		uint8_t div = (sim_TCB0.CTRLA & TCB_CLKSEL_gm) == TCB_CLKSEL_DIV2_gc ? 2 : 1;
+		flag_set(F_TCB0, TCB_CAPT_bm);
+		tcb_next_ps += cycles_ps((double)(sim_TCB0.CCMP + 1) * div);
+	}
+
+	if (tca_next_ps && tca_next_ps <= sim_now_ps) {
+		flag_set(F_TCA0, TCA_SINGLE_OVF_bm);
+		tca_next_ps += tca_period_ps();
+	}
+
+	if (rtc_on && rtc_next_ps <= sim_now_ps) {
+		flag_set(F_RTC, RTC_OVF_bm);
+		rtc_next_ps += rtc_period_ps();
+	}
+
+	if (rtc_on && rtc_cmp_ps <= sim_now_ps) {
+		flag_set(F_RTC, RTC_CMP_bm);
+		rtc_cmp_ps += rtc_period_ps();
+	}
+
+	if (button_down_ps && button_down_ps <= sim_now_ps) {
+		button_down_ps = 0;
+		sim_PORTB.IN &= ~PIN2_bm;
+		uint8_t isc = sim_PORTB.PIN2CTRL & PORT_ISC_gm;
+		if (isc == PORT_ISC_FALLING_gc || isc == PORT_ISC_BOTHEDGES_gc)
+			flag_set(F_PORTB, PIN2_bm);
+	}
+
+	if (button_up_ps && button_up_ps <= sim_now_ps) {
+		button_up_ps = 0;
+		if (press_next < press_count) {			// Loads the next scheduled press
+			button_down_ps = press_at[press_next];
+			button_up_ps = press_at[press_next] + press_hold[press_next];
+			press_next++;
+		}
+		sim_PORTB.IN |= PIN2_bm;
+		uint8_t isc = sim_PORTB.PIN2CTRL & PORT_ISC_gm;
+		if (isc == PORT_ISC_RISING_gc || isc == PORT_ISC_BOTHEDGES_gc)
+			flag_set(F_PORTB, PIN2_bm);
+	}
+}
+
+//***************************************************************************
+//
+// Function Name : static uint8_t dispatch (void)
+//
+// This function runs the handler of every pending and enabled interrupt while the
+// global interrupt flag is set, like the AVR does between instructions. As on the
+// part, the I flag is cleared while a handler runs. The SPI0 IF flag is cleared by
+// running its vector, and the USART0 DRE flag by writing the transmit buffer; every
+// other flag must be cleared by the handler.
+//
+//**************************************************************************
+
+static void call_isr (void (*isr)(void), const char* name) {
+	if (!isr) {
+		fprintf(stderr, "sim: %s is enabled and pending but has no ISR\n", name);
+		exit(1);
+	}
+	in_isr = 1;
+	sim_SREG &= ~CPU_I_bm;
+	sim_stats.interrupts++;
+	isr();
+	sim_SREG |= CPU_I_bm;
+	in_isr = 0;
+	sim_poll();
+}
+
+static uint8_t dispatch (void) {
+	uint8_t ran = 0;
+
+	for (unsigned long guard = 0; !in_isr && (sim_SREG & CPU_I_bm); guard++) {
+		if (guard > 1000000) {
+			fprintf(stderr, "sim: interrupt flag is never cleared\n");
+			exit(1);
+		}
+		if (sim_RTC.INTCTRL & flags[F_RTC] & (RTC_OVF_bm | RTC_CMP_bm))
+			call_isr(RTC_CNT_vect, "RTC_CNT_vect");
+		else if (sim_TCA0.SINGLE.INTCTRL & flags[F_TCA0] & TCA_SINGLE_OVF_bm)
+			call_isr(TCA0_OVF_vect, "TCA0_OVF_vect");
+		else if (sim_TCB0.INTCTRL & flags[F_TCB0] & TCB_CAPT_bm)
+			call_isr(TCB0_INT_vect, "TCB0_INT_vect");
+		else if ((sim_SPI0.INTCTRL & SPI_IE_bm) && (flags[F_SPI0] & SPI_IF_bm)) {
+			flag_clr(F_SPI0, SPI_IF_bm);
+			call_isr(SPI0_INT_vect, "SPI0_INT_vect");
+		}
+		else if ((sim_USART0.CTRLA & USART_DREIE_bm) && (flags[F_USART0] & USART_DREIF_bm))
+			call_isr(USART0_DRE_vect, "USART0_DRE_vect");
+		else if ((sim_USART0.CTRLA & USART_TXCIE_bm) && (flags[F_USART0] & USART_TXCIF_bm))
+			call_isr(USART0_TXC_vect, "USART0_TXC_vect");
+		else if ((sim_PORTB.PIN2CTRL & PORT_ISC_gm) && (flags[F_PORTB] & PIN2_bm))
+			call_isr(PORTB_PORT_vect, "PORTB_PORT_vect");
+		else
+			break;
+		ran = 1;
+	}
+	return ran;
+}
+
+//***************************************************************************
+//
+// Function Name : void sim_advance_ps (uint64_t ps)
+//
+// This function lets ps picoseconds of CPU time pass. Peripheral events that fall
+// inside that time are applied in order, and interrupts are dispatched after each.
+// Time spent in interrupt handlers extends the wait, like it does for a busy loop.
+//
+//**************************************************************************
+
+static void check_limit (void) {
+	if (running && sim_now_ps >= run_limit_ps)
+		sim_stop();
+}
+
+void sim_advance_ps (uint64_t ps) {
+	uint64_t end = sim_now_ps + ps;
+
+	sim_poll();
+	for (;;) {
+		uint64_t next = next_event();
+		if (next > end) break;
+		sim_now_ps = next;
+		fire_events();
+		uint64_t before = sim_now_ps;
+		dispatch();
+		end += sim_now_ps - before;
+		sim_poll();
+	}
+	sim_now_ps = end;
+	sim_poll();
+	dispatch();
+	check_limit();
+}
+
+//***************************************************************************
+//
+// Function Name : void* sim_io (void* reg)
+//
+// This function is called on every access to a peripheral register. It charges
+// the cost of the access, and keeps track of the deepest host stack use.
+//
+//**************************************************************************
+
+void* sim_io (void* reg) {
+	uintptr_t sp = (uintptr_t)__builtin_frame_address(0);
+	if (stack_base && sp < stack_base && stack_base - sp > sim_stats.stack_peak)
+		sim_stats.stack_peak = stack_base - sp;
+
+	if (!in_sim) {
+		in_sim = 1;
+		sim_advance_ps(cycles_ps(SIM_IO_CYCLES));
+		in_sim = 0;
+	}
+	rtc_sync();
+	return reg;
+}
+
+//***************************************************************************
+//
+// Function Name : void sim_delay_cycles (double cycles)
+//
+// This function backs _delay_us and _delay_ms.
+//
+//**************************************************************************
+
+void sim_delay_cycles (double cycles) {
+	uint64_t ps = cycles_ps(cycles);
+	uint64_t start = sim_now_ps;
+	in_sim = 1;
+	sim_advance_ps(ps);
+	in_sim = 0;
+	sim_stats.delay_ps += sim_now_ps - start;
+}
+
+//***************************************************************************
+//
+// Function Name : void sim_sleep (void)
+//
+// This function backs sleep_cpu. The CPU stops until the next event that runs an
+// interrupt handler. An enabled interrupt that is already pending, such as one that
+// came in between cli() and the sei() right before sleep_cpu(), wakes it right away,
+// like on the part. Sleeping with no event left to wake up ends the run.
+//
+// In standby only the RTC and the PB2 edge keep running, so going to standby with an
+// SPI0 or USART0 transfer, a TCB0 gap or TCA0 still running is reported as an error.
+//
+//**************************************************************************
+
+void sim_sleep (void) {
+	if (!(sim_SLPCTRL.CTRLA & SLPCTRL_SEN_bm))
+		return;
+
+	uint8_t standby = (sim_SLPCTRL.CTRLA & SLPCTRL_SMODE_gm) == SLPCTRL_SMODE_STDBY_gc;
+	in_sim = 1;
+	sim_poll();
+	if (standby && (spi_done_ps || usart_done_ps || tcb_next_ps || tca_next_ps)) {
+		fprintf(stderr, "sim: standby sleep while SPI0, USART0, TCB0 or TCA0 is running\n");
+		exit(1);
+	}
+	uint64_t start = sim_now_ps;
+	if (dispatch()) {						// Already pending, the CPU wakes up at once
+		in_sim = 0;
+		return;
+	}
+	for (;;) {
+		uint64_t next = next_event();
+		if (next == UINT64_MAX || (running && next >= run_limit_ps)) {
+			sim_stats.sleep_ps += (running ? run_limit_ps : sim_now_ps) - sim_now_ps;
+			if (running) sim_now_ps = run_limit_ps;
+			if (standby) sim_stats.standby_ps += sim_now_ps - start;
+			in_sim = 0;
+			sim_stop();
+			return;
+		}
+		sim_stats.sleep_ps += next - sim_now_ps;
+		sim_now_ps = next;
+		fire_events();
+		if (dispatch()) break;
+		sim_poll();
+	}
+	if (standby)
+		sim_stats.standby_ps += sim_now_ps - start;
+	in_sim = 0;
+}
+
+//***************************************************************************
+//
+// Function Name : void sim_button_press (uint64_t at_ps, uint64_t hold_ps)
+//
+// This function schedules a press of the PB2 pushbutton. Up to SIM_PRESSES presses
+// can be scheduled, in time order, and each one must start after the last is released.
+//
+//**************************************************************************
+
+void sim_button_press (uint64_t at_ps, uint64_t hold_ps) {
+	if (!button_up_ps) {
+		button_down_ps = at_ps;
+		button_up_ps = at_ps + hold_ps;
+	}
+	else if (press_count < SIM_PRESSES) {
+		press_at[press_count] = at_ps;
+		press_hold[press_count++] = hold_ps;
+	}
+}
+
+//***************************************************************************
+//
+// Function Name : int sim_run (void (*fn)(void), uint64_t limit_ps) & void sim_stop (void)
+//
+// sim_run calls fn until it returns or until limit_ps of simulated time has passed,
+// whichever is first, and returns 1 if the limit was hit. sim_stop ends the run.
+//
+//**************************************************************************
+
+int sim_run (void (*fn)(void), uint64_t limit_ps) {
+	running = 1;
+	run_limit_ps = sim_now_ps + limit_ps;
+	if (setjmp(run_jmp)) {
+		running = 0;
+		in_isr = 0;
+		in_sim = 0;
+		return 1;
+	}
+	fn();
+	running = 0;
+	return 0;
+}
+
+void sim_stop (void) {
+	if (running)
+		longjmp(run_jmp, 1);
+	fprintf(stderr, "sim: firmware is waiting on an event that can't happen\n");
+	exit(1);
+}
+
+//***************************************************************************
+//
+// Function Name : void sim_reset (void) & void sim_stats_reset (void)
+//
+// These functions put every register back to its reset value and power up every
+// DOG LCD, or just clear the statistics.
+//
+//**************************************************************************
+
+void sim_stats_reset (void) {
+	memset(&sim_stats, 0, sizeof(sim_stats));
+	for (uint8_t i = 0; i < SIM_PANELS; i++) {
+		sim_lcd[i].bytes = sim_lcd[i].commands = sim_lcd[i].data = 0;
+		sim_lcd[i].overruns = 0;
+	}
+}
+
+void sim_reset (void) {
+	memset(&sim_VPORTA, 0, sizeof(sim_VPORTA));
+	memset(&sim_VPORTB, 0, sizeof(sim_VPORTB));
+	memset(&sim_VPORTC, 0, sizeof(sim_VPORTC));
+	memset(&sim_VPORTD, 0, sizeof(sim_VPORTD));
+	memset(&sim_PORTA, 0, sizeof(sim_PORTA));
+	memset(&sim_PORTB, 0, sizeof(sim_PORTB));
+	memset(&sim_PORTMUX, 0, sizeof(sim_PORTMUX));
+	memset(&sim_SPI0, 0, sizeof(sim_SPI0));
+	memset(&sim_USART0, 0, sizeof(sim_USART0));
+	memset(&sim_TCB0, 0, sizeof(sim_TCB0));
+	memset(&sim_TCA0, 0, sizeof(sim_TCA0));
+	memset(&sim_RTC, 0, sizeof(sim_RTC));
+	memset(&sim_CLKCTRL, 0, sizeof(sim_CLKCTRL));
+	memset(&sim_SLPCTRL, 0, sizeof(sim_SLPCTRL));
+	sim_SPI0.DATA = SIM_SPI_EMPTY;
+	sim_USART0.TXDATAL = SIM_SPI_EMPTY;
+	sim_CLKCTRL.OSCHFCTRLA = CLKCTRL_FRQSEL_4M_gc;
+	sim_CLKCTRL.MCLKSTATUS = CLKCTRL_OSCHFS_bm;	// The oscillator settles at once
+	clock_sel = sim_CLKCTRL.OSCHFCTRLA;
+	sim_PORTB.IN = PIN2_bm;					// Pushbutton is released
+	sim_SREG = 0;
+	for (uint8_t f = 0; f < F_COUNT; f++)
+		flag_clr(f, 0xFF);
+	flag_set(F_USART0, USART_DREIF_bm);		// The transmit buffer starts out empty
+
+	spi_done_ps = usart_done_ps = tcb_next_ps = tca_next_ps = 0;
+	usart_buf = SIM_SPI_EMPTY;
+	button_down_ps = button_up_ps = 0;
+	press_next = press_count = 0;
+	rtc_on = 0;
+	in_isr = in_sim = 0;
+	sim_now_ps = 0;
+
+	memset(sim_lcd, 0, sizeof(sim_lcd));
+	for (uint8_t i = 0; i < SIM_PANELS; i++) {
+		memset(sim_lcd[i].ddram, ' ', SIM_DDRAM_SIZE);
+		sim_lcd[i].entry = 0x02;
+		sim_lcd[i].function = 0x18;			// 8 bit, 2 line after power on reset
+	}
+	sim_stats_reset();
+}
+
+void sim_stack_base (void) {
+	stack_base = (uintptr_t)__builtin_frame_address(0);
+	sim_stats.stack_peak = 0;
+}
+
+//***************************************************************************
+//
+// Function Name : void sim_lcd_row (uint8_t panel, uint8_t row, char* out) & void sim_lcd_print (FILE* out)
+//
+// sim_lcd_row copies the 16 characters shown on one row of a DOG LCD, taking the
+// line mode and display shift into account. sim_lcd_print draws every DOG LCD side
+// by side, LCD0 on the left. A single line shown in the double height font is
+// drawn twice to stand in for the big characters.
+//
+//**************************************************************************
+
+static uint8_t lcd_rows (const sim_lcd_t* lcd) {
+	return (lcd->function & 0x08) ? 3 : 1;	// DOGM163 glass shows 3 lines, or 1 line when N = 0
+}
+
+void sim_lcd_row (uint8_t panel, uint8_t row, char* out) {
+	const sim_lcd_t* lcd = &sim_lcd[panel];
+	uint8_t rows = lcd_rows(lcd);
+	uint8_t base, width;
+
+	if (rows == 1) { base = 0x00; width = 80; }
+	else { base = row << 4; width = 16; }
+
+	for (uint8_t i = 0; i < 16; i++) {
+		uint8_t c = lcd->ddram[base + ((i + lcd->shift) % width + width) % width];
+		out[i] = (c < 0x08) ? '0' + c : (c >= 0x20 && c < 0x7F) ? c : '?';
+	}
+	out[16] = '\0';
+}
+
+void sim_lcd_print (FILE* out) {
+	char row[17];
+
+	for (uint8_t r = 0; r < 3; r++) {
+		for (uint8_t i = 0; i < SIM_PANELS; i++) {
+			uint8_t rows = lcd_rows(&sim_lcd[i]);
+			if (rows == 1 && (sim_lcd[i].function & 0x04) && r < 2)
+				sim_lcd_row(i, 0, row);
+			else if (r < rows)
+				sim_lcd_row(i, r, row);
+			else
+				memset(row, ' ', 16), row[16] = '\0';
+			fprintf(out, "|%s|", row);
+		}
+		fputc('\n', out);
+	}
+}
@@ -0,0 +1,93 @@
+//***************************************************************************
+//
+// File Name : sim.h
+// Title : DOGM163 / ST7036 controller simulator
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This header declares the host side of the simulator. The firmware sources are
+// compiled against the replacement <avr/io.h>, <avr/interrupt.h> and <util/delay.h>
+// in this directory, and every register access, delay and sleep is routed here.
+// The simulator keeps a model of SPI0, USART0, TCB0, TCA0, the RTC and PORTB, decodes each byte that
+// reaches a selected DOG LCD, keeps a copy of each controller's DDRAM and counts
+// how much simulated time is spent on the wire, in delays and in sleep.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : ST7036 datasheet, instruction table and execution times
+//
+// Revision History : Initial version
+//
+//
+//**************************************************************************
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef LCD_PANELS
+#define LCD_PANELS 2						// Must match the firmware, give -DLCD_PANELS=n to every file
+#endif
+#define SIM_PANELS LCD_PANELS				// DOG LCDs on the simulated bus, wired as in lcd_panels
+#define SIM_DDRAM_SIZE 128
+#define SIM_PRESSES 8						// Pushbutton presses that can be scheduled ahead
+
+#define SIM_PS_PER_US 1000000ULL
+#define SIM_PS_PER_MS 1000000000ULL
+
+typedef struct {
+	uint8_t ddram[SIM_DDRAM_SIZE];
+	uint8_t cgram[64];
+	uint8_t ac;								// Address counter
+	uint8_t cgram_mode;						// 1 when the last address set was a CGRAM address
+	uint8_t entry;							// Entry mode bits, I/D and S
+	uint8_t display;						// Display on/off bits, D, C and B
+	uint8_t function;						// Function set bits, DL, N, DH and IS
+	uint8_t bias;							// Bias set bits, BS and FX
+	uint8_t power;							// Power/icon/contrast bits
+	uint8_t follower;						// Follower control bits
+	uint8_t contrast;						// Low contrast bits
+	int16_t shift;							// Display shift, in columns, positive to the left
+	uint64_t busy_until;					// End of the last instruction's execution time
+	unsigned long bytes, commands, data;	// Bytes received
+	unsigned long overruns;					// Bytes received while still executing
+} sim_lcd_t;
+
+typedef struct {
+	uint64_t bus_ps;						// Time spent shifting bytes out
+	uint64_t delay_ps;						// Time spent in _delay_us and _delay_ms
+	uint64_t sleep_ps;						// Time spent asleep
+	uint64_t standby_ps;					// Part of sleep_ps spent in standby
+	unsigned long bytes, commands, data;	// Bytes that reached a selected DOG LCD
+	unsigned long lost;						// Bytes sent with no DOG LCD selected
+	unsigned long collisions;				// DATA written while a transfer was in progress
+	unsigned long interrupts;				// Interrupt handlers run
+	unsigned long clock_changes;			// Writes that changed the CPU clock
+	uintptr_t stack_peak;					// Deepest host stack seen below sim_stack_base
+} sim_stats_t;
+
+extern sim_lcd_t sim_lcd[SIM_PANELS];
+extern sim_stats_t sim_stats;
+extern uint64_t sim_now_ps;
+extern FILE* sim_trace;					// Set to log every byte a DOG LCD receives
+
+void sim_reset (void);
+void sim_stats_reset (void);
+double sim_cpu_hz (void);
+double sim_spi_hz (void);
+void sim_advance_ps (uint64_t ps);
+void sim_sleep (void);
+void sim_button_press (uint64_t at_ps, uint64_t hold_ps);
+int sim_run (void (*fn)(void), uint64_t limit_ps);
+void sim_stop (void);
+void sim_stack_base (void);
+void sim_lcd_print (FILE* out);
+void sim_lcd_row (uint8_t panel, uint8_t row, char* out);
+
+#endif /* SIM_H_ */
@@ -0,0 +1,205 @@
+//***************************************************************************
+//
+// File Name : sim_main.c
+// Title : DOGM163 / ST7036 simulator driver
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This program runs the real firmware sources against the simulated chain of
+// DOGM163 displays. It brings every DOG LCD up with init_lcd_dog, times
+// still_display, a full down_scroll_display and a few jumps and steps back through
+// the rows, and draws every panel after each step. It then brings them up again with init_big_lcd_dog, goes back to 3 line
+// mode and runs the big font marquee, drawing it every MARQUEE_DRAW columns. It is
+// built and run from the repository root:
+//
+// gcc -Wall -Isim -I. -o sim_lcd sim/sim_main.c sim/sim.c DOGM163WA.c functions.c events.c sysclk.c layout.c glyph.c
+// ./sim_lcd			(add -v to draw every frame of the scroll, -t to log every byte)
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : ST7036 datasheet, instruction table and execution times
+//
+// Revision History : Initial version
+//
+//
+//**************************************************************************
+
+#include <string.h>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "sim.h"
+#include "DOGM163WA.h"
+#include "functions.h"
+#include "events.h"
+#include "layout_rows.h"
+
+static uint8_t verbose;
+
+static uint64_t mark_ps;
+static sim_stats_t mark_stats;
+
+static void mark (void) {
+	mark_ps = sim_now_ps;
+	mark_stats = sim_stats;
+}
+
+static void report (const char* what) {
+	printf("%-22s %10.3f ms  %5lu bytes (%lu cmd, %lu data)  bus %8.3f ms  delay %8.3f ms\n", what,
+		(sim_now_ps - mark_ps) / 1e9,
+		sim_stats.bytes - mark_stats.bytes,
+		sim_stats.commands - mark_stats.commands,
+		sim_stats.data - mark_stats.data,
+		(sim_stats.bus_ps - mark_stats.bus_ps) / 1e9,
+		(sim_stats.delay_ps - mark_stats.delay_ps) / 1e9);
+}
+
+static void draw (void) {
+	sim_lcd_print(stdout);
+	putchar('\n');
+}
+
+//***************************************************************************
+//
+// Function Name : static void run_scroll (void)
+//
+// This function starts a down scroll and runs the same service, clock and sleep
+// loop as main until the scroll is over.
+//
+//**************************************************************************
+
+static void run_scroll (void) {
+	down_scroll_display();
+	while (scroll_service()) {
+		if (verbose) {
+			lcd_spi_flush();
+			draw();
+		}
+		idle_sleep();
+		if (scroll_pending())
+			display_clock(SYSCLK_FAST_MHZ);
+	}
+	lcd_spi_flush();
+}
+
+//***************************************************************************
+//
+// Function Name : static void run_marquee (uint8_t steps)
+//
+// This function runs the big font marquee for the given number of columns with the
+// same service, clock and sleep loop as main and draws it every MARQUEE_DRAW columns.
+//
+//**************************************************************************
+
+#define MARQUEE_DRAW 8
+
+static void run_marquee (uint8_t steps) {
+	uint32_t next = clock_ticks();
+
+	marquee_start();
+	for (uint8_t i = 1; i <= steps; i++) {
+		next += (uint32_t)MARQUEE_SPEED * CLOCK_HZ / 1000;
+		while ((int32_t)(clock_ticks() - next) < 0) {
+			if (scroll_pending())
+				display_clock(SYSCLK_FAST_MHZ);
+			display_service();
+			idle_sleep();
+		}
+		if (verbose || i % MARQUEE_DRAW == 0) {
+			marquee_service();
+			lcd_spi_flush();
+			draw();
+		}
+	}
+	marquee_stop();
+	display_service();						// Still display again
+	lcd_spi_flush();
+}
+
+static void firmware (void) {
+	mark();
+	init_lcd_dog();
+	report("init_lcd_dog");
+	init_events();
+
+	sei();
+	display_clock(SYSCLK_FAST_MHZ);
+	mark();
+	still_display();
+	lcd_spi_flush();
+	report("still_display (first)");
+	draw();
+
+	mark();
+	still_display();
+	lcd_spi_flush();
+	report("still_display (again)");
+
+	mark();
+	display_clock(SYSCLK_FAST_MHZ);
+	run_scroll();
+	report("down_scroll_display");
+	printf("%lu wake ups, %lu frames sent, awake %lu ppm of the time\n", (unsigned long)loop_stats.wakeups,
+		(unsigned long)loop_stats.frames, (unsigned long)loop_duty_ppm());
+	draw();
+
+	mark();
+	scroll_jump(LAYOUT_SECTION_NAMES);
+	lcd_spi_flush();
+	report("scroll_jump (names)");
+	draw();
+
+	mark();
+	for (uint8_t i = 0; i < 4; i++)
+		scroll_up();
+	lcd_spi_flush();
+	report("scroll_up x4");
+	draw();
+
+	mark();
+	scroll_jump(LAYOUT_SECTION_THANKS);
+	lcd_spi_flush();
+	report("scroll_jump (thanks)");
+	draw();
+	scroll_stop();
+
+	cli();
+	mark();
+	init_big_lcd_dog();
+	report("init_big_lcd_dog");
+	lcd_spi_flush();
+	draw();
+
+	init_lcd_dog();
+	sei();
+	mark();
+	display_clock(SYSCLK_FAST_MHZ);
+	run_marquee(LCD_PANELS * LCD_COLS + sizeof(MARQUEE_TEXT) - 1);
+	report("marquee");
+	draw();
+}
+
+int main (int argc, char** argv) {
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-v"))
+			verbose = 1;
+		else if (!strcmp(argv[i], "-t"))
+			sim_trace = stdout;
+	}
+
+	sim_reset();
+	if (sim_run(firmware, 600000 * SIM_PS_PER_MS))
+		printf("stopped at the %.0f s limit\n", sim_now_ps / 1e12);
+
+	unsigned long overruns = 0;
+	for (uint8_t i = 0; i < SIM_PANELS; i++)
+		overruns += sim_lcd[i].overruns;
+	printf("%lu bytes sent before the last instruction finished, %lu lost, %lu collisions\n",
+		overruns, sim_stats.lost, sim_stats.collisions);
+	return overruns || sim_stats.lost || sim_stats.collisions;
+}
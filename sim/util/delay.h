@@ -0,0 +1,34 @@
+//***************************************************************************
+//
+// File Name : util/delay.h (simulator)
+// Title : Host busy-wait delays for the DOGM163 simulator
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// Like avr-libc, the delays are turned into a number of CPU cycles using the
+// F_CPU the caller was compiled with. The simulator then lets that many cycles
+// pass at the clock the part is actually running at, so a delay compiled for
+// the wrong clock is just as wrong here as it is on the part.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : avr-libc <util/delay.h>
+//
+// Revision History : Initial version
+//
+//
+//**************************************************************************
+
+#ifndef SIM_UTIL_DELAY_H_
+#define SIM_UTIL_DELAY_H_
+
+void sim_delay_cycles (double cycles);
+
+#define _delay_us(us) sim_delay_cycles((double)(us) * (F_CPU) / 1e6)
+#define _delay_ms(ms) sim_delay_cycles((double)(ms) * (F_CPU) / 1e3)
+
+#endif /* SIM_UTIL_DELAY_H_ */
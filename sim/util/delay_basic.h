@@ -0,0 +1,37 @@
+//***************************************************************************
+//
+// File Name : util/delay_basic.h (simulator)
+// Title : Host busy-wait loops for the DOGM163 simulator
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// Like avr-libc, _delay_loop_2 spins for 4 CPU cycles per count, and a count of 0
+// means 65536. The simulator lets those cycles pass at the clock the part is
+// running at, so a loop count worked out from the current clock is right at any
+// clock setting.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : avr-libc <util/delay_basic.h>
+//
+// Revision History : Initial version
+//
+//
+//**************************************************************************
+
+#ifndef SIM_UTIL_DELAY_BASIC_H_
+#define SIM_UTIL_DELAY_BASIC_H_
+
+#include <stdint.h>
+
+void sim_delay_cycles (double cycles);
+
+static inline void _delay_loop_2 (uint16_t count) {
+	sim_delay_cycles(4.0 * (count ? count : 65536.0));
+}
+
+#endif /* SIM_UTIL_DELAY_BASIC_H_ */
@@ -0,0 +1,114 @@
+//***************************************************************************
+//
+// File Name : sysclk.c
+// Title :
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This file defines the CPU clock control and the delays that follow the clock the
+// CPU is running at.
+//
+// Warnings :
+// Restrictions : none
+// Algorithms : none
+// References : AVR128DB48 datasheet, CLKCTRL.OSCHFCTRLA
+//
+// Revision History : Initial version
+//
+//
+//**************************************************************************
+
+#include <util/delay_basic.h>
+
+#include "sysclk.h"
+
+static uint8_t sysclk = SYSCLK_BOOT_MHZ;				// CPU clock in MHz
+
+//***************************************************************************
+//
+// Function Name : void sysclk_set(uint8_t mhz)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function sets the internal high frequency oscillator to mhz and waits for it
+// to be stable. The steps are shown below:
+// 1) Finds the FRQSEL setting for mhz
+// 2) Writes it to CLKCTRL.OSCHFCTRLA through the configuration change protection
+// 3) Waits for the oscillator to be stable and records the new clock
+//
+// Warnings : The caller must wait for TCB0 and SPI0 to be idle first, and set them up
+//			  again afterwards
+// Restrictions : mhz must be 1, 2, 3, 4, 8, 12, 16, 20 or 24
+// Algorithms : none
+// References : AVR128DB48 datasheet, CLKCTRL.OSCHFCTRLA
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void sysclk_set(uint8_t mhz) {
+	uint8_t frqsel = mhz <= 4 ? (mhz - 1) << 2 : (mhz / 4 + 3) << 2;	// 1MHz steps up to 4MHz, then 4MHz steps
+	
+	_PROTECTED_WRITE(CLKCTRL.OSCHFCTRLA, (CLKCTRL.OSCHFCTRLA & ~CLKCTRL_FRQSEL_gm) | frqsel);
+	while (!(CLKCTRL.MCLKSTATUS & CLKCTRL_OSCHFS_bm)) {}	// Waits for the oscillator to be stable
+	sysclk = mhz;
+}
+
+//***************************************************************************
+//
+// Function Name : uint8_t sysclk_mhz(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns the CPU clock in MHz.
+//
+//**************************************************************************
+
+uint8_t sysclk_mhz(void) {
+	return sysclk;
+}
+
+//***************************************************************************
+//
+// Function Name : void sysclk_delay_us(uint16_t us) & void sysclk_delay_ms(uint16_t ms)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// These functions busy wait for at least us microseconds or ms milliseconds at the
+// CPU clock currently selected. A microsecond is sysclk / 4 counts of _delay_loop_2,
+// rounded up, and a millisecond is sysclk * 250 counts.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : _delay_loop_2, 4 CPU cycles per count
+// References : avr-libc <util/delay_basic.h>
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void sysclk_delay_us(uint16_t us) {
+	uint32_t count = ((uint32_t)us * sysclk + 3) / 4;
+	
+	for (; count > 0xFFFF; count -= 0x10000)
+		_delay_loop_2(0);								// A count of 0 runs 65536 times
+	if (count)
+		_delay_loop_2((uint16_t)count);
+}
+
+void sysclk_delay_ms(uint16_t ms) {
+	while (ms--)
+		_delay_loop_2(sysclk * 250);
+}
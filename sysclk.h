@@ -0,0 +1,114 @@
+//***************************************************************************
+//
+// File Name : sysclk.h
+// Title :
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This header file declares the CPU clock control. The internal high frequency
+// oscillator starts at SYSCLK_BOOT_MHZ after reset. The main loop raises it to
+// SYSCLK_FAST_MHZ while frames are being built and sent, and drops it to
+// SYSCLK_IDLE_MHZ while it sleeps between them. The delays below work out their
+// loop counts from the clock the CPU is running at, so they stay right at every
+// setting, unlike _delay_us and _delay_ms which are fixed to F_CPU at compile time.
+//
+// Warnings : Timers clocked from the CPU clock (TCB0, SPI0) must be idle or set up
+//			  again when the clock is changed
+// Restrictions : none
+// Algorithms : none
+// References : AVR128DB48 datasheet, CLKCTRL.OSCHFCTRLA
+//
+// Revision History : Initial version
+//
+//
+//**************************************************************************
+
+#ifndef SYSCLK_H_
+#define SYSCLK_H_
+
+#include <avr/io.h>
+
+#define SYSCLK_BOOT_MHZ 4								// Internal oscillator after reset
+#define SYSCLK_FAST_MHZ 24								// While frames are built and sent
+#define SYSCLK_IDLE_MHZ 1								// While asleep between frames
+#define F_CPU (SYSCLK_BOOT_MHZ * 1000000UL)				// For <util/delay.h>, which only knows the clock after reset
+
+//***************************************************************************
+//
+// Function Name : void sysclk_set(uint8_t mhz)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function sets the internal high frequency oscillator to mhz and waits for it
+// to be stable. The steps are shown below:
+// 1) Finds the FRQSEL setting for mhz
+// 2) Writes it to CLKCTRL.OSCHFCTRLA through the configuration change protection
+// 3) Waits for the oscillator to be stable and records the new clock
+//
+// Warnings : The caller must wait for TCB0 and SPI0 to be idle first, and set them up
+//			  again afterwards
+// Restrictions : mhz must be 1, 2, 3, 4, 8, 12, 16, 20 or 24
+// Algorithms : none
+// References : AVR128DB48 datasheet, CLKCTRL.OSCHFCTRLA
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void sysclk_set(uint8_t mhz);
+
+//***************************************************************************
+//
+// Function Name : uint8_t sysclk_mhz(void)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// This function returns the CPU clock in MHz.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : none
+// References : none
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+uint8_t sysclk_mhz(void);
+
+//***************************************************************************
+//
+// Function Name : void sysclk_delay_us(uint16_t us) & void sysclk_delay_ms(uint16_t ms)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : AVR128DB48
+// Target Hardware : AVR128DB48
+// Author : Dylan Wong
+//
+// These functions busy wait for at least us microseconds or ms milliseconds at the
+// CPU clock currently selected. Interrupts that run during the wait make it longer.
+//
+// Warnings : none
+// Restrictions : none
+// Algorithms : _delay_loop_2, 4 CPU cycles per count
+// References : avr-libc <util/delay_basic.h>
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+void sysclk_delay_us(uint16_t us);
+
+void sysclk_delay_ms(uint16_t ms);
+
+
+#endif /* SYSCLK_H_ */
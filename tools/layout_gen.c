@@ -0,0 +1,833 @@
+//***************************************************************************
+//
+// File Name : layout_gen.c
+// Title : Layout generator
+// Date : 10/16/2026
+// Version : 1.8
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This program turns the messages in messages.h into layout_rows.h, which holds them
+// in flash in two forms:
+// layout_source -> The messages as one layout source stream (see layout.h), which the
+//					firmware lays out a row at a time while it scrolls. It doesn't
+//					depend on the number of DOG LCDs. It is compressed with a
+//					dictionary of the strings that come up most often
+// layout_rows -> The finished canvas rows for every DOG LCD, for firmware built with
+//				  LAYOUT_STREAM=0, which reads the rows straight from flash, and the
+//				  row each section starts on in layout_section_rows
+// show_stream -> The whole down scroll compiled into the bytes the DOG LCDs are sent, for
+//				  firmware built with SCROLL_SHOW=1. Step r takes the DOG LCDs from the
+//				  frame with row r - 1 at the top to the frame with row r at the top, and
+//				  starts at show_steps[r - 1]. Each step is a list of records, ended by
+//				  SHOW_STEP:
+//				  SHOW_ALL | n -> The set DDRAM address command, then n characters,
+//								  broadcast to every DOG LCD
+//				  SHOW_EACH -> The runs of one row for every DOG LCD, LCD0's first, each
+//							   list ended by a 0 byte. A run is its number of characters,
+//							   the set DDRAM address command and the characters. The
+//							   firmware sends them a byte for each DOG LCD in turn
+//				  Only the runs of characters that change from one frame to the next are
+//				  in it, found the same way lcd_update_block and lcd_update_slices find
+//				  them, so it sends the same bytes the firmware would. Its size and how
+//				  long it keeps the bus busy are written into layout_rows.h and printed
+// All of them come from the same layout engine, layout.c, so they show the same rows. It is
+// built and run from the repository root:
+//
+// gcc -Wall -Isim -I. -o layout_gen tools/layout_gen.c layout.c
+// ./layout_gen > layout_rows.h
+//
+// The number of DOG LCDs on the wall is given as an optional argument (2 by default),
+// and must match LCD_PANELS in firmware that uses the row table or the show stream:
+//
+// ./layout_gen 4 > layout_rows.h
+//
+// With -b the rows of the text sections are balanced for that number of DOG LCDs by
+// layout_balance, which writes its row breaks into the source stream as LAYOUT_BREAK:
+//
+// ./layout_gen -b 2 > layout_rows.h
+//
+// The text sections are centered unless -a gives another alignment, left, right,
+// center or full, which is stored in their kind bytes:
+//
+// ./layout_gen -a full 2 > layout_rows.h
+//
+// -u leaves the dictionary empty, to see how much flash it saves.
+//
+// layout_rows.h is committed, and must be generated again whenever messages.h or
+// the layout rules change.
+//
+// Warnings : Empty cells are written as spaces, since a null character would show
+//			  CGRAM character 0 on the DOG LCD
+// Restrictions : The source stream can be at most 64 KB after compression, and each text
+//				  at most 64 KB before
+// Algorithms : layout_start, layout_next, layout_more, layout_balance, byte pair encoding,
+//				delta encoding of the frames
+// References :
+//
+// Revision History : Initial version
+//					  1.1 - One canvas table for any number of DOG LCDs
+//					  1.2 - Rows laid out by the streaming layout engine, which has no
+//							limit on the number of rows
+//					  1.3 - Section numbers and the row each one starts on
+//					  1.4 - Balanced rows with -b
+//					  1.5 - Alignment of the text sections with -a
+//					  1.6 - Dictionary compression of the source stream
+//					  1.7 - Show stream of the down scroll
+//					  1.8 - Check of full justification over more than one paragraph
+//
+//**************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "messages.h"
+#include "layout.h"
+#include "DOGM163WA.h"
+#include "functions.h"
+
+#define PANEL_COLS 16												// Columns on one DOG LCD
+#define MAX_PANELS 8
+#define MAX_COLS (MAX_PANELS * PANEL_COLS)
+#define MAX_SOURCE 0xFFFF
+#define MAX_PLAIN 0x100000
+#define MAX_SECTIONS 255
+#define MAX_TOKENS 128
+#define SYMBOLS (LAYOUT_TOKEN + MAX_TOKENS)								// Characters, then tokens
+#define MAX_SHOW 0xFFFF
+
+// Records of the show stream
+#define SHOW_STEP 0x00													// Ends the records of one step
+#define SHOW_ALL 0x40													// Run broadcast to every DOG LCD
+#define SHOW_EACH 0x80													// Runs of one row for each DOG LCD
+#define SHOW_KIND 0xC0													// Bits of the first byte that hold the kind
+#define SHOW_LEN 0x1F													// Bits of the first byte that hold the number of characters
+
+static char plain[MAX_PLAIN];											// Source stream before compression
+static size_t plain_size;
+static char source[MAX_SOURCE];
+static size_t source_size;
+static size_t source_body;												// Where the sections start in source
+static uint8_t balance_cols;											// Canvas width to balance the text sections for, 0 to fill each row
+static uint8_t text_align = LAYOUT_CENTER;								// Alignment ORed into the kind byte of the text sections
+static char show[MAX_SHOW];												// Show stream
+static size_t show_size;
+static unsigned long show_bus;											// Bytes the show stream puts on the bus
+static double show_us;													// Time the show stream keeps the bus busy
+
+static const char* const align_names[] = { "center", "left", "right", "full" };	// In the order of LAYOUT_ALIGN
+
+//***************************************************************************
+//
+// Function Name : static void add(uint8_t kind, const char* text, char end)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This function appends to the source stream: a kind byte if kind isn't 0, then text
+// followed by end if text isn't NULL.
+//
+// Revision History : Initial version
+//					  1.1 - Appends to plain, which is compressed into source at the end
+//
+//**************************************************************************
+
+static void add(uint8_t kind, const char* text, char end) {
+	size_t len = text ? strlen(text) + 1 : 0;
+	if (plain_size + (kind != 0) + len > MAX_PLAIN) {
+		fprintf(stderr, "layout_gen: the messages don't fit in a %d byte source\n", MAX_PLAIN);
+		exit(1);
+	}
+	if (kind)
+		plain[plain_size++] = kind;
+	if (text) {
+		memcpy(&plain[plain_size], text, len - 1);
+		plain_size += len - 1;
+		plain[plain_size++] = end;
+	}
+}
+
+//***************************************************************************
+//
+// Function Name : static void add_text(const char* text)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This function appends a text section, with its rows balanced if balance_cols is set.
+//
+// Revision History : Initial version
+//					  1.1 - Alignment in the kind byte
+//
+//**************************************************************************
+
+static void add_text(const char* text) {
+	size_t start = plain_size + 1;
+	add(LAYOUT_TEXT | text_align, text, '\0');
+	if (balance_cols) {
+		size_t size = strlen(text) / 2 + 1;							// No more words than that
+		layout_word_t* words = malloc(size * sizeof(layout_word_t));
+		if (words == NULL || !layout_balance(&plain[start], balance_cols, words, size)) {
+			fprintf(stderr, "layout_gen: couldn't balance the text\n");
+			exit(1);
+		}
+		free(words);
+	}
+}
+
+//***************************************************************************
+//
+// Function Name : static void add_names(char** names)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This function appends a names section with every name up to the first NULL.
+//
+//**************************************************************************
+
+static void add_names(char** names) {
+	add(LAYOUT_NAMES, NULL, 0);
+	for (int i = 0; names[i] != NULL; i++)
+		add(0, names[i], '\n');
+	add(0, "", '\0');
+}
+
+//***************************************************************************
+//
+// Function Name : static void add_blank(int n)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This function appends n blank rows.
+//
+//**************************************************************************
+
+static void add_blank(int n) {
+	for (int i = 0; i < n; i++)
+		add(LAYOUT_BLANK, NULL, 0);
+}
+
+//***************************************************************************
+//
+// Function Name : static int compress(int max_tokens)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This function compresses plain into source, with a dictionary of up to max_tokens
+// tokens, and returns the number of tokens. The steps are shown below:
+// 1) Counts every pair of neighbouring symbols in the stream. Symbols are characters
+//	  and the tokens made so far, and only the characters shown on the DOG LCD are paired
+// 2) Makes the pair that saves the most bytes, after the bytes the token takes in the
+//	  dictionary, into a new token, and puts it in place of each pair from left to right
+// 3) Goes back to 1) until nothing more is saved, or there are max_tokens tokens
+// 4) Drops the tokens that ended up inside longer ones only, and writes the dictionary
+//	  and the stream into source
+// Every token is kept as its whole string, so the firmware expands one in a single look
+// up instead of going through the pairs it was made from.
+//
+//**************************************************************************
+
+static int compress(int max_tokens) {
+	static int sym[MAX_PLAIN];
+	static int count[SYMBOLS][SYMBOLS];
+	char text[MAX_TOKENS][LAYOUT_TOKEN_MAX];
+	int len[SYMBOLS];
+	int number[MAX_TOKENS];											// Number of each token in the dictionary, -1 if unused
+	size_t n = plain_size;
+	int tokens = 0;
+
+	for (int s = 0; s < SYMBOLS; s++)
+		len[s] = 1;
+	for (size_t i = 0; i < n; i++) {
+		sym[i] = (unsigned char)plain[i];
+		if (sym[i] >= LAYOUT_TOKEN) {
+			fprintf(stderr, "layout_gen: the messages can only have characters below 0x%02X\n", LAYOUT_TOKEN);
+			exit(1);
+		}
+	}
+
+	while (tokens < max_tokens) {
+		int a = 0, b = 0, best = 0;
+		size_t last = 0;
+
+		memset(count, 0, sizeof(count));
+		for (size_t i = 0; i + 1 < n; i++) {
+			int x = sym[i], y = sym[i + 1];
+			if ((x < LAYOUT_TOKEN && (x < ' ' || x == 0x7F)) || (y < LAYOUT_TOKEN && (y < ' ' || y == 0x7F)))
+				continue;
+			if (len[x] + len[y] > LAYOUT_TOKEN_MAX)
+				continue;
+			if (x == y && i > 0 && last == i - 1 && sym[i - 1] == x)	// The pairs of a run of one symbol overlap
+				continue;
+			count[x][y]++;
+			last = i;
+		}
+		for (int x = 0; x < SYMBOLS; x++)
+			for (int y = 0; y < SYMBOLS; y++)
+				if (count[x][y] - (len[x] + len[y] + 2) > best) {	// A token costs its characters and its offset
+					best = count[x][y] - (len[x] + len[y] + 2);
+					a = x;
+					b = y;
+				}
+		if (!best)
+			break;
+
+		int t = LAYOUT_TOKEN + tokens;
+		char ca = a, cb = b;
+		memcpy(text[tokens], a < LAYOUT_TOKEN ? &ca : text[a - LAYOUT_TOKEN], len[a]);
+		memcpy(text[tokens] + len[a], b < LAYOUT_TOKEN ? &cb : text[b - LAYOUT_TOKEN], len[b]);
+		len[t] = len[a] + len[b];
+		tokens++;
+
+		size_t j = 0;
+		for (size_t i = 0; i < n; )
+			if (i + 1 < n && sym[i] == a && sym[i + 1] == b) {
+				sym[j++] = t;
+				i += 2;
+			}
+			else
+				sym[j++] = sym[i++];
+		n = j;
+	}
+
+	int used = 0;
+	for (int k = 0; k < tokens; k++)
+		number[k] = -1;
+	for (size_t i = 0; i < n; i++)								// Marks the tokens left in the stream
+		if (sym[i] >= LAYOUT_TOKEN)
+			number[sym[i] - LAYOUT_TOKEN] = 0;
+	for (int k = 0; k < tokens; k++)
+		if (number[k] >= 0)
+			number[k] = used++;
+
+	source_body = 1 + 2 * (used + 1);
+	for (int k = 0; k < tokens; k++)
+		if (number[k] >= 0)
+			source_body += len[LAYOUT_TOKEN + k];
+	if (source_body + n > MAX_SOURCE) {
+		fprintf(stderr, "layout_gen: the messages don't fit in a %d byte source\n", MAX_SOURCE);
+		exit(1);
+	}
+
+	size_t at = 1 + 2 * (used + 1);									// Characters of the next token
+	source[0] = used;
+	for (int k = 0; k < tokens; k++) {
+		if (number[k] < 0)
+			continue;
+		source[1 + 2 * number[k]] = at & 0xFF;
+		source[2 + 2 * number[k]] = at >> 8;
+		memcpy(&source[at], text[k], len[LAYOUT_TOKEN + k]);
+		at += len[LAYOUT_TOKEN + k];
+	}
+	source[1 + 2 * used] = at & 0xFF;
+	source[2 + 2 * used] = at >> 8;
+
+	source_size = source_body;
+	for (size_t i = 0; i < n; i++)
+		source[source_size++] = sym[i] < LAYOUT_TOKEN ? sym[i] : LAYOUT_TOKEN + number[sym[i] - LAYOUT_TOKEN];
+	return used;
+}
+
+//***************************************************************************
+//
+// Function Name : static void print_string(const char* buf, size_t from, size_t to)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This function prints the bytes of buf from up to to as one C string literal. Control
+// bytes are written as 3 digit octal escapes, which can't run on into the next character.
+//
+// Revision History : Initial version
+//					  1.1 - Any buffer, for the show stream
+//
+//**************************************************************************
+
+static void print_string(const char* buf, size_t from, size_t to) {
+	printf("\t\"");
+	for (size_t i = from; i < to; i++) {
+		unsigned char c = buf[i];
+		if (c == '\n')
+			printf("\\n");
+		else if (c < 0x20 || c >= 0x7F)
+			printf("\\%03o", c);
+		else {
+			if (c == '"' || c == '\\')
+				putchar('\\');
+			putchar(c);
+		}
+	}
+	printf("\"\n");
+}
+
+//***************************************************************************
+//
+// Function Name : static void print_source(void)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This function prints the source stream as a PROGMEM string: the offsets of the
+// dictionary on one line, then one line for each token, each section and each name.
+//
+// Revision History : Initial version
+//					  1.1 - Dictionary
+//
+//**************************************************************************
+
+static void print_source(void) {
+	size_t at = 1 + 2 * ((unsigned char)source[0] + 1);
+
+	printf("static const char layout_source[LAYOUT_SOURCE_SIZE] PROGMEM =\n");
+	print_string(source, 0, at);
+	for (int k = 0; k < (unsigned char)source[0]; k++) {			// Ends of the tokens from their offsets
+		size_t end = (unsigned char)source[3 + 2 * k] | (unsigned char)source[4 + 2 * k] << 8;
+		print_string(source, at, end);
+		at = end;
+	}
+	for (size_t i = source_body, from = source_body; i < source_size; i++) {
+		char c = source[i];
+		char next = i + 1 < source_size ? source[i + 1] : LAYOUT_END;
+		if ((c == '\n' && next != '\0') || (c == '\0' && next != '\0') || (i == from && c == LAYOUT_BLANK) || i + 1 == source_size) {
+			print_string(source, from, i + 1);
+			from = i + 1;
+		}
+	}
+	printf(";\n\n");
+}
+
+//***************************************************************************
+//
+// Function Name : static void print_rows(int rows, uint8_t cols)
+// Date : 10/16/2026
+// Version : 1.2
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This function prints the first rows of the canvas as a PROGMEM table with one row of
+// canvas_cols characters, LCD0's 16 columns first.
+//
+// Revision History : Initial version
+//					  1.1 - Prints the whole canvas row instead of one DOG LCD
+//					  1.2 - Rows made one at a time by layout_next
+//
+//**************************************************************************
+
+static void print_rows(int rows, uint8_t cols) {
+	layout_t lay;
+	char row[MAX_COLS];
+
+	layout_start(&lay, source, cols);
+	printf("static const char layout_rows[LAYOUT_TABLE_ROWS][LAYOUT_PANELS * LAYOUT_COLS] PROGMEM = {\n");
+	for (int i = 0; i < rows; i++) {
+		layout_next(&lay, row);
+		printf("\t\"");
+		for (int j = 0; j < cols; j++) {
+			if (row[j] == '"' || row[j] == '\\')
+				putchar('\\');
+			putchar(row[j]);
+		}
+		printf("\"%s\n", i + 1 < rows ? "," : "");
+	}
+	printf("};\n\n");
+}
+
+//***************************************************************************
+//
+// Function Name : static int scan_rows(uint8_t cols, int* section_rows, int* sections)
+// Date : 10/16/2026
+// Version : 1.1
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This function lays the whole source out once and returns the last row that shows
+// something on any of the DOG LCDs, or 1 if there is none past the first row. The first
+// row of each text and names section is stored in section_rows, and the number of them
+// in sections.
+//
+// Revision History : Initial version
+//					  1.1 - First row of each section
+//
+//**************************************************************************
+
+static int scan_rows(uint8_t cols, int* section_rows, int* sections) {
+	layout_t lay;
+	char row[MAX_COLS];
+	int last = 1;
+
+	*sections = 0;
+	layout_start(&lay, source, cols);
+	do {
+		while (*sections < lay.section && *sections < MAX_SECTIONS)	// Sections that start on this row
+			section_rows[(*sections)++] = lay.row;
+		if (layout_next(&lay, row) && lay.row - 1 > last)
+			last = lay.row - 1;
+	} while (layout_more(&lay));
+	return last;
+}
+
+//***************************************************************************
+//
+// Function Name : static void show_add(char c)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This function appends a byte to the show stream.
+//
+//**************************************************************************
+
+static void show_add(char c) {
+	if (show_size == MAX_SHOW) {
+		fprintf(stderr, "layout_gen: the show doesn't fit in a %d byte stream\n", MAX_SHOW);
+		exit(1);
+	}
+	show[show_size++] = c;
+}
+
+//***************************************************************************
+//
+// Function Name : static double show_row(const char* old, const char* row, uint8_t addr, int panels)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This function appends the records that take DDRAM address addr on, from the canvas
+// row old to row, to the show stream, and returns how long they keep the bus busy in
+// us. The steps are shown below:
+// 1) Marks the columns that change, on any DOG LCD if row is the same on every DOG LCD,
+//	  as display_rows broadcasts it then, and on each DOG LCD on its own otherwise
+// 2) Joins them into runs, and two runs separated by a single unchanged column into one,
+//	  as lcd_shadow_run does
+// 3) Writes the runs of a broadcast row as SHOW_ALL records, and the runs of the other
+//	  rows as one SHOW_EACH record
+// A byte costs the execution time of the ST7036 or its time on the wire at
+// LCD_SCK_MAX_HZ, whichever is longer. The bytes of a SHOW_EACH record go to the DOG LCDs
+// in turn, so it takes as long as the DOG LCD with the most bytes executes them, or as
+// long as all of its bytes are on the wire.
+//
+//**************************************************************************
+
+static double show_row(const char* old, const char* row, uint8_t addr, int panels) {
+	double exec_us = LCD_EXEC_NS / 1000.0;
+	double wire_us = 8e6 / LCD_SCK_MAX_HZ;
+	uint8_t changed[PANEL_COLS];
+	int same = 1;
+	int most = 0;
+	int bytes = 0;
+
+	for (int p = 1; p < panels; p++)
+		if (memcmp(row, &row[p * PANEL_COLS], PANEL_COLS))
+			same = 0;
+	if (!same)
+		show_add(SHOW_EACH);
+
+	for (int p = 0; p < (same ? 1 : panels); p++) {
+		int sent = 0;
+		for (int c = 0; c < PANEL_COLS; c++) {
+			changed[c] = 0;
+			for (int q = same ? 0 : p; q < (same ? panels : p + 1); q++)
+				if (old[q * PANEL_COLS + c] != row[q * PANEL_COLS + c])
+					changed[c] = 1;
+		}
+
+		for (int c = 0; c < PANEL_COLS; ) {
+			while (c < PANEL_COLS && !changed[c])
+				c++;
+			if (c == PANEL_COLS)
+				break;
+			int start = c;
+			int end = ++c;									// Grows the run until two unchanged columns in a row
+			while (c < PANEL_COLS) {
+				if (changed[c])
+					end = ++c;
+				else if (c + 1 < PANEL_COLS && changed[c + 1])
+					c++;
+				else
+					break;
+			}
+			c = end;
+
+			show_add(same ? SHOW_ALL | (end - start) : end - start);
+			show_add(0x80 | (addr + start));				// set DDRAM address
+			for (int i = start; i < end; i++)
+				show_add(row[p * PANEL_COLS + i]);
+			sent += end - start + 1;
+		}
+		if (!same)
+			show_add(0);									// End of this DOG LCD's runs
+		if (sent > most)
+			most = sent;
+		bytes += sent;
+	}
+
+	show_bus += bytes;
+	return most * exec_us > bytes * wire_us ? most * exec_us : bytes * wire_us;
+}
+
+//***************************************************************************
+//
+// Function Name : static double make_show(int rows, int panels, size_t* steps)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This function lays out the first rows + 2 canvas rows and compiles the down scroll over
+// them into the show stream, one step for each frame after the first. Where step r starts
+// is stored in steps[r - 1]. It returns how long the longest step keeps the bus busy in us.
+//
+//**************************************************************************
+
+static double make_show(int rows, int panels, size_t* steps) {
+	uint8_t cols = panels * PANEL_COLS;
+	char* canvas = malloc((size_t)(rows + 2) * cols);
+	layout_t lay;
+	double worst = 0;
+
+	if (canvas == NULL) {
+		fprintf(stderr, "layout_gen: out of memory\n");
+		exit(1);
+	}
+	layout_start(&lay, source, cols);
+	for (int i = 0; i < rows + 2; i++)
+		layout_next(&lay, &canvas[i * cols]);
+
+	for (int r = 1; r < rows; r++) {
+		double us = 0;
+		steps[r - 1] = show_size;
+		for (int j = 0; j < 3; j++)
+			us += show_row(&canvas[(r - 1 + j) * cols], &canvas[(r + j) * cols], LCD_ROW_ADDR(j), panels);
+		show_add(SHOW_STEP);
+		show_us += us;
+		if (us > worst)
+			worst = us;
+	}
+	free(canvas);
+	return worst;
+}
+
+//***************************************************************************
+//
+// Function Name : static void print_show(int rows, const size_t* steps)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This function prints where each step of the show stream starts as a PROGMEM table,
+// and the show stream as a PROGMEM string with one line for each step.
+//
+//**************************************************************************
+
+static void print_show(int rows, const size_t* steps) {
+	printf("static const uint16_t show_steps[SHOW_STEPS] PROGMEM = {");
+	for (int r = 1; r < rows; r++)
+		printf("%s%zu", r > 1 ? ", " : " ", steps[r - 1]);
+	printf(" };\n\n");
+	printf("static const char show_stream[SHOW_STREAM_SIZE] PROGMEM =\n");
+	for (int r = 1; r < rows; r++)
+		print_string(show, steps[r - 1], r + 1 < rows ? steps[r] : show_size);
+	printf(";\n\n");
+}
+
+//***************************************************************************
+//
+// Function Name : static void check_full(uint8_t cols)
+// Date : 10/16/2026
+// Version : 1.0
+// Target MCU : Linux host
+// Target Hardware : none
+// Author : Dylan Wong
+//
+// This function checks that a fully justified text of more than one paragraph, balanced
+// by layout_balance for a canvas of cols characters, is laid out the way it should be.
+// The rows that end at a break written by layout_balance must be stretched to both edges,
+// and the last row of each paragraph must be left as it is. It exits with an error if
+// they aren't, so layout_rows.h is never generated by a layout engine that gets them wrong.
+//
+// Warnings : None
+// Restrictions : cols must be at least 16
+// Algorithms : layout_balance, layout_start, layout_next, layout_more
+// References :
+//
+// Revision History : Initial version
+//
+//**************************************************************************
+
+static void check_full(uint8_t cols) {
+	static const char text[] = "Every row of this paragraph but the last one is stretched to both edges of the canvas.\n"
+		"So are the rows of this one, which is long enough to need a few of them.\nShort one.";
+	char src[3 + 1 + sizeof(text) + 1] = { 0, 3, 0, LAYOUT_TEXT | LAYOUT_FULL };	// No tokens, then the section
+	char* body = &src[4];
+	layout_word_t words[sizeof(text) / 2 + 1];
+	layout_t lay;
+	char row[MAX_COLS];
+	char want[MAX_COLS];
+	size_t at = 0;
+	int rows = 0, stretched = 0;
+
+	memcpy(body, text, sizeof(text));
+	src[sizeof(src) - 1] = LAYOUT_END;
+	if (!layout_balance(body, cols, words, sizeof(words) / sizeof(words[0]))) {
+		fprintf(stderr, "layout_gen: couldn't balance the full justification check\n");
+		exit(1);
+	}
+
+	layout_start(&lay, src, cols);
+	do {
+		size_t end = at;
+		while (body[end] != '\n' && body[end] != LAYOUT_BREAK && body[end] != '\0')
+			end++;
+		if (!layout_next(&lay, row) || end - at > cols)
+			break;
+		if (body[end] == LAYOUT_BREAK) {						// Row in a paragraph, stretched to both edges
+			if (row[0] == ' ' || row[cols - 1] == ' ')
+				break;
+			stretched++;
+		}
+		else {													// Last row of a paragraph, left as it is
+			memset(want, ' ', cols);
+			memcpy(want, &body[at], end - at);
+			if (memcmp(row, want, cols) != 0)
+				break;
+		}
+		rows++;
+		at = end + 1;
+	} while (body[at - 1] != '\0' && layout_more(&lay));
+
+	if (!rows || body[at - 1] != '\0' || !stretched || layout_more(&lay)) {
+		fprintf(stderr, "layout_gen: row %d of the full justification check is laid out wrong\n", rows);
+		exit(1);
+	}
+}
+
+int main(int argc, char** argv) {
+	int max_tokens = MAX_TOKENS;
+	int balance = 0;
+	int panels = 2;
+	int arg;
+
+	for (arg = 1; arg < argc && argv[arg][0] == '-'; arg++) {
+		if (strcmp(argv[arg], "-b") == 0)
+			balance = 1;
+		else if (strcmp(argv[arg], "-u") == 0)
+			max_tokens = 0;
+		else if (strcmp(argv[arg], "-a") == 0 && arg + 1 < argc) {
+			int i = 0;
+			while (i < 4 && strcmp(argv[arg + 1], align_names[i]) != 0)
+				i++;
+			if (i == 4)
+				break;
+			text_align = i << 4;
+			arg++;
+		}
+		else
+			break;
+	}
+	if (arg < argc)
+		panels = atoi(argv[arg++]);
+	if (arg < argc || panels < 1 || panels > MAX_PANELS) {
+		fprintf(stderr, "usage: %s [-b] [-u] [-a center|left|right|full] [panels 1-%d]\n", argv[0], MAX_PANELS);
+		return 1;
+	}
+	uint8_t cols = panels * PANEL_COLS;
+	if (balance)
+		balance_cols = cols;
+	check_full(cols);
+
+	add_text(message);						// Same order the firmware used to build the buffers in at boot
+	add_blank(3);
+
+	add_names(names);
+	add_blank(3);
+
+	add_text(special_thanks);
+	add_blank(3);
+	add(LAYOUT_END, NULL, 0);
+	int tokens = compress(max_tokens);
+
+	int section_rows[MAX_SECTIONS];
+	int sections;
+	int last = scan_rows(cols, section_rows, &sections);	// Last row with text on it
+	int rows = last;						// Rows that can be at the top of a frame, the last frame ends one row below the text
+	int table_rows = rows + 2;				// The last frame also shows the 2 rows below its top row
+	size_t* steps = malloc(rows * sizeof(size_t));
+	if (steps == NULL) {
+		fprintf(stderr, "layout_gen: out of memory\n");
+		return 1;
+	}
+	double worst = make_show(rows, panels, steps);
+	unsigned long show_ms = (unsigned long)(rows - 1) * SCROLLSPEED + SCROLLHOLD;
+	fprintf(stderr, "layout_gen: show stream of %d steps in %zu bytes, %lu bytes on the bus in %.1f ms, %.2f ms in the longest step, "
+		"%.1f s long\n", rows - 1, show_size, show_bus, show_us / 1000, worst / 1000, show_ms / 1000.0);
+	if (worst / 1000 > SCROLLSPEED)
+		fprintf(stderr, "layout_gen: a step of the show keeps the bus busy for longer than SCROLLSPEED\n");
+
+	printf("//***************************************************************************\n");
+	printf("//\n");
+	printf("// File Name : layout_rows.h\n");
+	printf("//\n");
+	printf("// Generated by tools/layout_gen.c from messages.h, do not edit.\n");
+	printf("//\n");
+	printf("//**************************************************************************\n\n");
+	printf("#ifndef LAYOUT_ROWS_H_\n#define LAYOUT_ROWS_H_\n\n");
+	printf("#include <avr/pgmspace.h>\n\n");
+	printf("#define LAYOUT_PANELS %d\t\t\t\t\t\t\t// DOG LCDs across the canvas\n", panels);
+	printf("#define LAYOUT_COLS %d\t\t\t\t\t\t\t// Columns on each DOG LCD\n", PANEL_COLS);
+	printf("#define LAYOUT_ROWS %d\t\t\t\t\t\t\t// Rows the down scroll can bring to the top\n", rows);
+	printf("#define LAYOUT_TABLE_ROWS %d\n", table_rows);
+	printf("#define LAYOUT_SOURCE_SIZE %zu\t\t\t\t\t\t// Bytes of layout_source, %zu before compression with %d tokens\n", source_size, plain_size, tokens);
+	printf("#define LAYOUT_SECTIONS %d\t\t\t\t\t\t// Text and names sections, for scroll_jump\n", sections);
+	printf("#define LAYOUT_SECTION_MESSAGE 0\n");
+	printf("#define LAYOUT_SECTION_NAMES 1\n");
+	printf("#define LAYOUT_SECTION_THANKS 2\n\n");
+	printf("#define SHOW_STEPS %d\t\t\t\t\t\t\t// Steps of the down scroll, one for each row it moves\n", rows - 1);
+	printf("#define SHOW_STREAM_SIZE %zu\t\t\t\t\t\t// Bytes of show_stream, %lu bytes on the bus\n", show_size, show_bus);
+	printf("#define SHOW_BUS_US %lu\t\t\t\t\t\t// Time the steps keep the bus busy, %lu us in the longest one\n",
+		(unsigned long)(show_us + 0.5), (unsigned long)(worst + 0.5));
+	printf("#define SHOW_MS %lu\t\t\t\t\t\t\t// Length of the show, at SCROLLSPEED with the SCROLLHOLD at the end\n", show_ms);
+	printf("#define SHOW_STEP 0x%02X\t\t\t\t\t\t\t// Ends the records of one step\n", SHOW_STEP);
+	printf("#define SHOW_ALL 0x%02X\t\t\t\t\t\t\t// Run broadcast to every DOG LCD\n", SHOW_ALL);
+	printf("#define SHOW_EACH 0x%02X\t\t\t\t\t\t\t// Runs of one row for each DOG LCD, each list ended by a 0 byte\n", SHOW_EACH);
+	printf("#define SHOW_KIND 0x%02X\n", SHOW_KIND);
+	printf("#define SHOW_LEN 0x%02X\n\n", SHOW_LEN);
+	print_source();
+	printf("static const uint16_t layout_section_rows[LAYOUT_SECTIONS] PROGMEM = {");	// Rows of the row table each section starts on
+	for (int i = 0; i < sections; i++)
+		printf("%s%d", i ? ", " : " ", section_rows[i]);
+	printf(" };\n\n");
+	print_rows(table_rows, cols);
+	print_show(rows, steps);
+	free(steps);
+	printf("#endif /* LAYOUT_ROWS_H_ */\n");
+
+	return 0;
+}